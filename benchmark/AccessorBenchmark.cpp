@@ -0,0 +1,151 @@
+/******************************************************************************
+ * \file    AccessorBenchmark.cpp
+ * \author  Loh Xiao Qi
+ * \brief   Times the AccessorConversion kernels at every SIMD level against
+ *					the per component memcpy loop FetchData used before them.
+ *
+ *					AccessorBenchmark [element count] [repeats]
+ *
+ * \copyright	Copyright (c) 2022 Digipen Institute of Technology. Reproduction
+ *						or disclosure of this file or its contents without the prior
+ *						written consent of Digipen Institute of Technology is prohibited
+ ******************************************************************************/
+
+#include "Libraries/AccessorConversion.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+using SH_COMP::AccessorConversion;
+using SH_COMP::AccessorView;
+using SimdLevel = AccessorConversion::SimdLevel;
+
+/******************************************************************************
+ * The conversion FetchData did before AccessorConversion. Each component is
+ * copied into the low bytes of a zeroed 32 bit lane, which is only correct
+ * for unsigned sources read into integer types.
+ ******************************************************************************/
+template <typename T>
+static void LegacyCopy(AccessorView const& view, std::vector<T>& dst)
+{
+	auto const componentSize{ SizeOfType(view.componentType) };
+	dst.assign(view.count, T{});
+
+	for (size_t i{ 0 }; i < view.count; ++i)
+	{
+		auto src{ view[i] };
+		auto lane{ reinterpret_cast<uint32_t*>(&dst[i]) };
+		for (size_t j{ 0 }; j < view.componentCount; ++j)
+		{
+			std::memcpy(lane, src, componentSize);
+			src += componentSize;
+			++lane;
+		}
+	}
+}
+
+// Best time of repeats runs, in milliseconds
+template <typename Function>
+static double Time(unsigned repeats, Function&& function)
+{
+	double best{ std::numeric_limits<double>::max() };
+	for (unsigned i{ 0 }; i < repeats; ++i)
+	{
+		auto const start{ std::chrono::steady_clock::now() };
+		function();
+		std::chrono::duration<double, std::milli> const elapsed{ std::chrono::steady_clock::now() - start };
+		best = std::min(best, elapsed.count());
+	}
+
+	return best;
+}
+
+/******************************************************************************
+ * Converts the view into T at every level, checks each result against the
+ * scalar one and prints one line of timings. legacy also times LegacyCopy
+ * for cases it converted correctly.
+ ******************************************************************************/
+template <typename T>
+static bool Run(char const* label, AccessorView const& view, unsigned repeats, bool legacy)
+{
+	std::vector<T> reference;
+	AccessorConversion::LimitSimdLevel(SimdLevel::SCALAR);
+	view.CopyTo(reference);
+
+	std::cout << std::left << std::setw(28) << label << std::right << std::fixed << std::setprecision(2);
+
+	bool matches{ true };
+	std::vector<T> result;
+	if (legacy)
+	{
+		std::cout << std::setw(10) << Time(repeats, [&] { LegacyCopy(view, result); });
+		matches = matches && std::memcmp(result.data(), reference.data(), sizeof(T) * result.size()) == 0;
+	}
+	else
+	{
+		std::cout << std::setw(10) << "-";
+	}
+
+	for (auto const level : { SimdLevel::SCALAR, SimdLevel::SSE41, SimdLevel::AVX2 })
+	{
+		AccessorConversion::LimitSimdLevel(level);
+		if (AccessorConversion::GetSimdLevel() != level)
+		{
+			std::cout << std::setw(10) << "n/a";
+			continue;
+		}
+
+		std::cout << std::setw(10) << Time(repeats, [&] { view.CopyTo(result); });
+		matches = matches && std::memcmp(result.data(), reference.data(), sizeof(T) * result.size()) == 0;
+	}
+
+	AccessorConversion::LimitSimdLevel(SimdLevel::AVX2);
+	std::cout << (matches ? "" : "  MISMATCH") << "\n";
+	return matches;
+}
+
+int main(int argc, char** argv)
+{
+	size_t const count{ argc > 1 ? std::strtoull(argv[1], nullptr, 10) : size_t{ 1 } << 22 };
+	unsigned const repeats{ argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 10u };
+
+	// Enough bytes for count elements of the widest case, a 28 byte stride
+	std::vector<unsigned char> source(count * 28);
+	std::mt19937 random{ 1234 };
+	for (auto& byte : source)
+		byte = static_cast<unsigned char>(random());
+
+	auto const view = [&](ACCESSOR_COMPONENT_TYPE type, size_t components, size_t stride, size_t elements, bool normalized = false)
+	{
+		AccessorView result;
+		result.data = source.data();
+		result.componentType = type;
+		result.componentCount = components;
+		result.stride = stride;
+		result.count = elements;
+		result.normalized = normalized;
+		return result;
+	};
+
+	std::cout << count << " elements, best of " << repeats << " runs in ms\n";
+	std::cout << std::left << std::setw(28) << "case" << std::right
+		<< std::setw(10) << "legacy" << std::setw(10) << "scalar" << std::setw(10) << "sse4.1" << std::setw(10) << "avx2" << "\n";
+
+	bool matches{ true };
+	matches &= Run<SH_COMP::SHVec4i>("u8x4 -> SHVec4i", view(ACCESSOR_COMPONENT_TYPE::U_BYTE, 4, 4, count), repeats, true);
+	matches &= Run<SH_COMP::SHVec4i>("u16x4 -> SHVec4i", view(ACCESSOR_COMPONENT_TYPE::U_SHORT, 4, 8, count), repeats, true);
+	matches &= Run<uint32_t>("u16 -> uint32 (x3)", view(ACCESSOR_COMPONENT_TYPE::U_SHORT, 1, 2, count * 3), repeats, true);
+	matches &= Run<SH_COMP::SHVec4i>("u16x4 stride 28 -> SHVec4i", view(ACCESSOR_COMPONENT_TYPE::U_SHORT, 4, 28, count), repeats, true);
+	matches &= Run<SH_COMP::SHVec4>("unorm8x4 -> SHVec4", view(ACCESSOR_COMPONENT_TYPE::U_BYTE, 4, 4, count, true), repeats, false);
+	matches &= Run<SH_COMP::SHVec2>("snorm16x2 -> SHVec2", view(ACCESSOR_COMPONENT_TYPE::SHORT, 2, 4, count, true), repeats, false);
+
+	return matches ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,100 @@
+/******************************************************************************
+ * \file    LoadBenchmark.cpp
+ * \author  Loh Xiao Qi
+ * \brief   Times ModelView::Open on compiled .shmodel files, without and
+ *					with validation, so format changes can be measured for load
+ *					speed.
+ *
+ *					LoadBenchmark [repeats] <file.shmodel>...
+ *
+ *					Every run after the first reads from the page cache, so these
+ *					are warm load times.
+ *
+ * \copyright	Copyright (c) 2022 Digipen Institute of Technology. Reproduction
+ *						or disclosure of this file or its contents without the prior
+ *						written consent of Digipen Institute of Technology is prohibited
+ ******************************************************************************/
+
+#include "Libraries/MeshReader.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using SH_COMP::ModelView;
+
+struct LoadTimes
+{
+	double best;
+	double median;
+};
+
+// Best and median of repeats opens, in microseconds
+static bool Time(AssetPath const& path, unsigned repeats, bool validate, LoadTimes& times)
+{
+	std::vector<double> runs;
+	runs.reserve(repeats);
+
+	for (unsigned i{ 0 }; i < repeats; ++i)
+	{
+		auto const start{ std::chrono::steady_clock::now() };
+		ModelView view;
+		bool const opened{ view.Open(path, validate, std::cerr) };
+		std::chrono::duration<double, std::micro> const elapsed{ std::chrono::steady_clock::now() - start };
+
+		if (!opened)
+			return false;
+
+		runs.push_back(elapsed.count());
+	}
+
+	std::ranges::sort(runs);
+	times = { runs.front(), runs[runs.size() / 2] };
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	int first{ 1 };
+	unsigned repeats{ 100 };
+	if (argc > 1 && std::isdigit(static_cast<unsigned char>(argv[1][0])))
+	{
+		repeats = std::max(1u, static_cast<unsigned>(std::strtoul(argv[1], nullptr, 10)));
+		first = 2;
+	}
+
+	if (first >= argc)
+	{
+		std::cerr << "LoadBenchmark [repeats] <file.shmodel>...\n";
+		return EXIT_FAILURE;
+	}
+
+	std::cout << repeats << " opens per file in us\n";
+	std::cout << std::left << std::setw(32) << "file" << std::right
+		<< std::setw(14) << "open best" << std::setw(14) << "open median"
+		<< std::setw(14) << "valid best" << std::setw(14) << "valid median" << "\n";
+
+	bool result{ true };
+	for (int i{ first }; i < argc; ++i)
+	{
+		AssetPath const path{ argv[i] };
+
+		LoadTimes open, validated;
+		if (!Time(path, repeats, false, open) || !Time(path, repeats, true, validated))
+		{
+			result = false;
+			continue;
+		}
+
+		std::cout << std::left << std::setw(32) << path.filename().string() << std::right << std::fixed << std::setprecision(2)
+			<< std::setw(14) << open.best << std::setw(14) << open.median
+			<< std::setw(14) << validated.best << std::setw(14) << validated.median << "\n";
+	}
+
+	return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -56,4 +56,84 @@ project "ModelCompiler"
     defines{"_RELEASE"}
   
   filter "configurations:Publish"
-    flags {"ExcludeFromBuild"}
\ No newline at end of file
+    flags {"ExcludeFromBuild"}
+
+-- Times AccessorConversion at every SIMD level, see benchmark/AccessorBenchmark.cpp
+project "AccessorBenchmark"
+  kind "ConsoleApp"
+  language "C++"
+  cppdialect "C++20"
+  targetdir (outputdir)
+  objdir    (interdir)
+  systemversion "latest"
+
+  files
+  {
+    "%{prj.location}/benchmark/AccessorBenchmark.cpp",
+    "%{prj.location}/src/Libraries/AccessorConversion.h",
+    "%{prj.location}/src/Libraries/AccessorConversion.cpp"
+  }
+
+  includedirs
+  {
+    "%{prj.location}/src"
+  }
+
+  flags
+  {
+  	"MultiProcessorCompile"
+  }
+
+  warnings 'Extra'
+
+  filter "configurations:Debug"
+    symbols "On"
+    defines {"_DEBUG"}
+
+  filter "configurations:Release"
+    optimize "On"
+    defines{"_RELEASE"}
+
+  filter "configurations:Publish"
+    flags {"ExcludeFromBuild"}
+
+-- Times ModelView::Open with and without validation, see benchmark/LoadBenchmark.cpp
+project "LoadBenchmark"
+  kind "ConsoleApp"
+  language "C++"
+  cppdialect "C++20"
+  targetdir (outputdir)
+  objdir    (interdir)
+  systemversion "latest"
+
+  files
+  {
+    "%{prj.location}/benchmark/LoadBenchmark.cpp",
+    "%{prj.location}/src/Libraries/MeshReader.h",
+    "%{prj.location}/src/Libraries/MeshReader.cpp",
+    "%{prj.location}/src/Libraries/MappedFile.h",
+    "%{prj.location}/src/Libraries/MappedFile.cpp"
+  }
+
+  includedirs
+  {
+    "%{prj.location}/src"
+  }
+
+  flags
+  {
+  	"MultiProcessorCompile"
+  }
+
+  warnings 'Extra'
+
+  filter "configurations:Debug"
+    symbols "On"
+    defines {"_DEBUG"}
+
+  filter "configurations:Release"
+    optimize "On"
+    defines{"_RELEASE"}
+
+  filter "configurations:Publish"
+    flags {"ExcludeFromBuild"}
@@ -10,6 +10,8 @@
 #pragma once
 
 #include <filesystem>
+#include <cstdint>
+#include <string_view>
 
 // Typedefs
 typedef std::filesystem::path AssetPath;
@@ -115,10 +117,31 @@ constexpr std::string_view BUILT_IN_ASSET_ROOT{ "../../Built_In" };
 
 // ASSET EXTENSIONS
 constexpr std::string_view MODEL_EXTENSION {".shmodel"};
+constexpr std::string_view BUILD_CACHE_EXTENSION {".shcache"};
+
+// Bump whenever compiled output changes so stale cache entries are rebuilt
+constexpr uint32_t MODEL_COMPILER_VERSION{ 23 };
+
+// .shmodel LAYOUT
+// Streams start on MODEL_STREAM_ALIGNMENT, while mesh bodies, animation clips
+// and top level sections start on MODEL_SECTION_ALIGNMENT, so a mapped file
+// can be read in place. Magic is "SHMD" read as little endian uint32.
+constexpr uint32_t MODEL_FILE_MAGIC{ 0x444D4853 };
+constexpr size_t MODEL_STREAM_ALIGNMENT{ 16 };
+constexpr size_t MODEL_SECTION_ALIGNMENT{ 64 };
 
 // EXTERNAL EXTENSIONS
 constexpr std::string_view FBX_EXTENSION{ ".fbx" };
 constexpr std::string_view GLTF_EXTENSION{ ".gltf" };
+constexpr std::string_view GLB_EXTENSION{ ".glb" };
+
+// BINARY GLTF LAYOUT
+// Magic and chunk types are the ASCII tags read as little endian uint32
+constexpr uint32_t GLB_MAGIC{ 0x46546C67 };
+constexpr uint32_t GLB_CHUNK_JSON{ 0x4E4F534A };
+constexpr uint32_t GLB_CHUNK_BIN{ 0x004E4942 };
+constexpr size_t GLB_HEADER_SIZE{ 12 };
+constexpr size_t GLB_CHUNK_HEADER_SIZE{ 8 };
 
 // ATTRIBUTE NAMES
 // BASIC NEEDED
@@ -134,5 +157,6 @@ constexpr std::string_view ATT_COLOUR{ "COLOR_0" };
 
 constexpr std::string_view EXTERNALS[] = {
 	FBX_EXTENSION,
-	GLTF_EXTENSION
+	GLTF_EXTENSION,
+	GLB_EXTENSION
 };
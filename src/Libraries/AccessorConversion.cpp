@@ -0,0 +1,355 @@
+/******************************************************************************
+ * \file    AccessorConversion.cpp
+ * \author  Loh Xiao Qi
+ * \brief   Widening and deinterleaving kernels for gltf accessor data
+ * 
+ * \copyright	Copyright (c) 2022 Digipen Institute of Technology. Reproduction
+ *						or disclosure of this file or its contents without the prior
+ *						written consent of Digipen Institute of Technology is prohibited
+ ******************************************************************************/
+#include "AccessorConversion.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SH_COMP_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC allows any intrinsic to be used, gcc and clang need them enabled per
+// function so the rest of the file still builds for the baseline target
+#if defined(__GNUC__) || defined(__clang__)
+#define SH_COMP_TARGET(isa) __attribute__((target(isa)))
+#else
+#define SH_COMP_TARGET(isa)
+#endif
+
+namespace SH_COMP
+{
+  namespace
+  {
+    using SimdLevel = AccessorConversion::SimdLevel;
+
+    constexpr size_t LANE_SIZE{ sizeof(uint32_t) };
+
+    std::atomic<SimdLevel> simdLimit{ SimdLevel::AVX2 };
+
+    SimdLevel DetectSimdLevel() noexcept
+    {
+#if defined(SH_COMP_X86) && defined(_MSC_VER)
+      int info[4];
+      __cpuid(info, 0);
+      auto const maxLeaf{ info[0] };
+
+      __cpuid(info, 1);
+      bool const sse41{ (info[2] & (1 << 19)) != 0 };
+      bool const osxsave{ (info[2] & (1 << 27)) != 0 };
+      bool const avx{ (info[2] & (1 << 28)) != 0 };
+
+      bool avx2{ false };
+      if (maxLeaf >= 7)
+      {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+      }
+
+      // OS must also save the YMM registers across context switches
+      if (avx2 && avx && osxsave && (_xgetbv(0) & 0x6) == 0x6)
+        return SimdLevel::AVX2;
+
+      return sse41 ? SimdLevel::SSE41 : SimdLevel::SCALAR;
+#elif defined(SH_COMP_X86)
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx2"))
+        return SimdLevel::AVX2;
+
+      return __builtin_cpu_supports("sse4.1") ? SimdLevel::SSE41 : SimdLevel::SCALAR;
+#else
+      return SimdLevel::SCALAR;
+#endif
+    }
+
+    template <typename S, bool FLOAT_OUT>
+    void ConvertScalar(
+      unsigned char const* src, size_t srcStride,
+      size_t componentCount, size_t count,
+      unsigned char* dst, size_t dstStride,
+      float scale, float lowest
+    ) noexcept
+    {
+      for (size_t i{ 0 }; i < count; ++i, src += srcStride, dst += dstStride)
+      {
+        for (size_t j{ 0 }; j < componentCount; ++j)
+        {
+          S value;
+          std::memcpy(&value, src + j * sizeof(S), sizeof(S));
+
+          if constexpr (FLOAT_OUT)
+          {
+            float out{ static_cast<float>(value) };
+            if constexpr (!std::is_floating_point_v<S>)
+              out = std::max(out * scale, lowest);
+
+            std::memcpy(dst + j * LANE_SIZE, &out, LANE_SIZE);
+          }
+          else
+          {
+            uint32_t out;
+            // Float into an integer lane keeps the raw bits
+            if constexpr (std::is_floating_point_v<S>)
+              std::memcpy(&out, &value, LANE_SIZE);
+            else
+              out = static_cast<uint32_t>(value);
+
+            std::memcpy(dst + j * LANE_SIZE, &out, LANE_SIZE);
+          }
+        }
+      }
+    }
+
+#ifdef SH_COMP_X86
+    /***************************************************************************
+     * Tightly packed sources are handled as one flat run of n components.
+     * Each returns how many components it converted, the caller finishes the
+     * tail with the scalar loop.
+     ***************************************************************************/
+    template <typename S, bool FLOAT_OUT>
+    SH_COMP_TARGET("avx2")
+    size_t PackedAvx2(unsigned char const* src, unsigned char* dst, size_t n, float scale, float lowest) noexcept
+    {
+      auto const scaleVec{ _mm256_set1_ps(scale) };
+      auto const lowestVec{ _mm256_set1_ps(lowest) };
+
+      size_t i{ 0 };
+      for (; i + 8 <= n; i += 8)
+      {
+        __m256i lanes;
+        if constexpr (sizeof(S) == 1)
+        {
+          auto const raw{ _mm_loadl_epi64(reinterpret_cast<__m128i const*>(src + i)) };
+          lanes = std::is_signed_v<S> ? _mm256_cvtepi8_epi32(raw) : _mm256_cvtepu8_epi32(raw);
+        }
+        else
+        {
+          auto const raw{ _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i * 2)) };
+          lanes = std::is_signed_v<S> ? _mm256_cvtepi16_epi32(raw) : _mm256_cvtepu16_epi32(raw);
+        }
+
+        if constexpr (FLOAT_OUT)
+        {
+          auto const values{ _mm256_max_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(lanes), scaleVec), lowestVec) };
+          _mm256_storeu_ps(reinterpret_cast<float*>(dst + i * LANE_SIZE), values);
+        }
+        else
+        {
+          _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * LANE_SIZE), lanes);
+        }
+      }
+
+      return i;
+    }
+
+    template <typename S>
+    SH_COMP_TARGET("sse4.1")
+    __m128i WidenFour(unsigned char const* src) noexcept
+    {
+      if constexpr (sizeof(S) == 1)
+      {
+        int32_t word;
+        std::memcpy(&word, src, sizeof(word));
+        auto const raw{ _mm_cvtsi32_si128(word) };
+        return std::is_signed_v<S> ? _mm_cvtepi8_epi32(raw) : _mm_cvtepu8_epi32(raw);
+      }
+      else
+      {
+        auto const raw{ _mm_loadl_epi64(reinterpret_cast<__m128i const*>(src)) };
+        return std::is_signed_v<S> ? _mm_cvtepi16_epi32(raw) : _mm_cvtepu16_epi32(raw);
+      }
+    }
+
+    template <bool FLOAT_OUT>
+    SH_COMP_TARGET("sse4.1")
+    void StoreFour(unsigned char* dst, __m128i lanes, __m128 scale, __m128 lowest) noexcept
+    {
+      if constexpr (FLOAT_OUT)
+        _mm_storeu_ps(reinterpret_cast<float*>(dst), _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(lanes), scale), lowest));
+      else
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), lanes);
+    }
+
+    template <typename S, bool FLOAT_OUT>
+    SH_COMP_TARGET("sse4.1")
+    size_t PackedSse41(unsigned char const* src, unsigned char* dst, size_t n, float scale, float lowest) noexcept
+    {
+      auto const scaleVec{ _mm_set1_ps(scale) };
+      auto const lowestVec{ _mm_set1_ps(lowest) };
+
+      size_t i{ 0 };
+      for (; i + 4 <= n; i += 4)
+      {
+        StoreFour<FLOAT_OUT>(dst + i * LANE_SIZE, WidenFour<S>(src + i * sizeof(S)), scaleVec, lowestVec);
+      }
+
+      return i;
+    }
+
+    // Interleaved VEC4 sources, e.g. joints or weights sharing a vertex stride
+    template <typename S, bool FLOAT_OUT>
+    SH_COMP_TARGET("sse4.1")
+    void StridedVec4Sse41(
+      unsigned char const* src, size_t srcStride,
+      size_t count,
+      unsigned char* dst, size_t dstStride,
+      float scale, float lowest
+    ) noexcept
+    {
+      auto const scaleVec{ _mm_set1_ps(scale) };
+      auto const lowestVec{ _mm_set1_ps(lowest) };
+
+      for (size_t i{ 0 }; i < count; ++i, src += srcStride, dst += dstStride)
+      {
+        StoreFour<FLOAT_OUT>(dst, WidenFour<S>(src), scaleVec, lowestVec);
+      }
+    }
+#endif
+
+    template <typename S, bool FLOAT_OUT>
+    void Convert(
+      unsigned char const* src, size_t srcStride,
+      size_t componentCount, size_t count,
+      unsigned char* dst, size_t dstStride,
+      float scale = 1.f, float lowest = std::numeric_limits<float>::lowest()
+    ) noexcept
+    {
+      bool const packed{ srcStride == componentCount * sizeof(S) && dstStride == componentCount * LANE_SIZE };
+
+      if constexpr (sizeof(S) < LANE_SIZE)
+      {
+#ifdef SH_COMP_X86
+        auto const level{ AccessorConversion::GetSimdLevel() };
+        if (packed)
+        {
+          auto const n{ componentCount * count };
+          size_t done{ 0 };
+          if (level == SimdLevel::AVX2)
+            done = PackedAvx2<S, FLOAT_OUT>(src, dst, n, scale, lowest);
+          else if (level == SimdLevel::SSE41)
+            done = PackedSse41<S, FLOAT_OUT>(src, dst, n, scale, lowest);
+
+          ConvertScalar<S, FLOAT_OUT>(
+            src + done * sizeof(S), sizeof(S), 1, n - done,
+            dst + done * LANE_SIZE, LANE_SIZE, scale, lowest
+          );
+          return;
+        }
+
+        if (componentCount == 4 && level != SimdLevel::SCALAR)
+        {
+          StridedVec4Sse41<S, FLOAT_OUT>(src, srcStride, count, dst, dstStride, scale, lowest);
+          return;
+        }
+#endif
+      }
+      else if constexpr (std::is_floating_point_v<S> || !FLOAT_OUT)
+      {
+        // Same lane representation, only the layout can differ
+        if (packed)
+        {
+          std::memcpy(dst, src, componentCount * count * LANE_SIZE);
+          return;
+        }
+
+        for (size_t i{ 0 }; i < count; ++i, src += srcStride, dst += dstStride)
+        {
+          std::memcpy(dst, src, componentCount * LANE_SIZE);
+        }
+        return;
+      }
+
+      ConvertScalar<S, FLOAT_OUT>(src, srcStride, componentCount, count, dst, dstStride, scale, lowest);
+    }
+  }
+
+  AccessorConversion::SimdLevel AccessorConversion::GetSimdLevel() noexcept
+  {
+    static SimdLevel const level{ DetectSimdLevel() };
+    return std::min(level, simdLimit.load(std::memory_order_relaxed));
+  }
+
+  void AccessorConversion::LimitSimdLevel(SimdLevel level) noexcept
+  {
+    simdLimit.store(level, std::memory_order_relaxed);
+  }
+
+  void AccessorConversion::ToUint32(
+    unsigned char const* src, size_t srcStride, ACCESSOR_COMPONENT_TYPE type,
+    size_t componentCount, size_t count,
+    void* dst, size_t dstStride
+  ) noexcept
+  {
+    auto const out{ static_cast<unsigned char*>(dst) };
+
+    switch (type)
+    {
+    case ACCESSOR_COMPONENT_TYPE::BYTE:
+      Convert<int8_t, false>(src, srcStride, componentCount, count, out, dstStride);
+      break;
+    case ACCESSOR_COMPONENT_TYPE::U_BYTE:
+      Convert<uint8_t, false>(src, srcStride, componentCount, count, out, dstStride);
+      break;
+    case ACCESSOR_COMPONENT_TYPE::SHORT:
+      Convert<int16_t, false>(src, srcStride, componentCount, count, out, dstStride);
+      break;
+    case ACCESSOR_COMPONENT_TYPE::U_SHORT:
+      Convert<uint16_t, false>(src, srcStride, componentCount, count, out, dstStride);
+      break;
+    case ACCESSOR_COMPONENT_TYPE::U_INT:
+      Convert<uint32_t, false>(src, srcStride, componentCount, count, out, dstStride);
+      break;
+    case ACCESSOR_COMPONENT_TYPE::FLOAT:
+      Convert<float, false>(src, srcStride, componentCount, count, out, dstStride);
+      break;
+    }
+  }
+
+  void AccessorConversion::ToFloat(
+    unsigned char const* src, size_t srcStride, ACCESSOR_COMPONENT_TYPE type, bool normalized,
+    size_t componentCount, size_t count,
+    void* dst, size_t dstStride
+  ) noexcept
+  {
+    auto const out{ static_cast<unsigned char*>(dst) };
+
+    // gltf normalisation: unsigned c / max, signed max(c / max, -1)
+    auto const scale = [normalized](float maxValue) { return normalized ? 1.f / maxValue : 1.f; };
+    auto const lowest{ normalized ? -1.f : std::numeric_limits<float>::lowest() };
+
+    switch (type)
+    {
+    case ACCESSOR_COMPONENT_TYPE::BYTE:
+      Convert<int8_t, true>(src, srcStride, componentCount, count, out, dstStride, scale(127.f), lowest);
+      break;
+    case ACCESSOR_COMPONENT_TYPE::U_BYTE:
+      Convert<uint8_t, true>(src, srcStride, componentCount, count, out, dstStride, scale(255.f));
+      break;
+    case ACCESSOR_COMPONENT_TYPE::SHORT:
+      Convert<int16_t, true>(src, srcStride, componentCount, count, out, dstStride, scale(32767.f), lowest);
+      break;
+    case ACCESSOR_COMPONENT_TYPE::U_SHORT:
+      Convert<uint16_t, true>(src, srcStride, componentCount, count, out, dstStride, scale(65535.f));
+      break;
+    case ACCESSOR_COMPONENT_TYPE::U_INT:
+      Convert<uint32_t, true>(src, srcStride, componentCount, count, out, dstStride);
+      break;
+    case ACCESSOR_COMPONENT_TYPE::FLOAT:
+      Convert<float, true>(src, srcStride, componentCount, count, out, dstStride);
+      break;
+    }
+  }
+}
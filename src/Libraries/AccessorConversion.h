@@ -0,0 +1,102 @@
+/******************************************************************************
+ * \file    AccessorConversion.h
+ * \author  Loh Xiao Qi
+ * \brief   Kernels to widen and deinterleave gltf accessor components into
+ *					the 32 bit lanes used by the asset types. SSE4.1 and AVX2 paths
+ *					are picked at runtime with a scalar fallback.
+ * 
+ * \copyright	Copyright (c) 2022 Digipen Institute of Technology. Reproduction
+ *						or disclosure of this file or its contents without the prior
+ *						written consent of Digipen Institute of Technology is prohibited
+ ******************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+#include "AssetMacros.h"
+#include "PseudoMath.h"
+
+namespace SH_COMP
+{
+	// Whether the 32 bit lanes of T hold floats or unsigned integers
+	template <typename T>
+	constexpr bool HAS_FLOAT_COMPONENTS{ !std::is_integral_v<T> && !std::is_same_v<T, SHVec4i> };
+
+	struct AccessorConversion
+	{
+		enum class SimdLevel : uint8_t
+		{
+			SCALAR,
+			SSE41,
+			AVX2
+		};
+
+		static SimdLevel GetSimdLevel() noexcept;
+
+		// Caps the level the kernels use, so paths can be compared on one
+		// machine. A cap above what the CPU supports has no effect.
+		static void LimitSimdLevel(SimdLevel level) noexcept;
+
+		/*************************************************************************
+		 * Reads count elements of componentCount components each. Elements start
+		 * srcStride bytes apart in src and are written dstStride bytes apart in
+		 * dst, one 32 bit lane per component.
+		 *
+		 * Integer sources are zero or sign extended by ToUint32. ToFloat converts
+		 * integer sources to float, applying gltf normalisation if requested.
+		 *************************************************************************/
+		static void ToUint32(
+			unsigned char const* src, size_t srcStride, ACCESSOR_COMPONENT_TYPE type,
+			size_t componentCount, size_t count,
+			void* dst, size_t dstStride
+		) noexcept;
+
+		static void ToFloat(
+			unsigned char const* src, size_t srcStride, ACCESSOR_COMPONENT_TYPE type, bool normalized,
+			size_t componentCount, size_t count,
+			void* dst, size_t dstStride
+		) noexcept;
+	};
+
+	/****************************************************************************
+	 * Strided view over the elements of one accessor inside a source buffer.
+	 * data already includes the bufferView and accessor byte offsets, stride is
+	 * the bufferView byteStride or the element size when the view is packed.
+	 ****************************************************************************/
+	struct AccessorView
+	{
+		unsigned char const* data{ nullptr };
+		size_t stride{ 0 };
+		size_t count{ 0 };
+		size_t componentCount{ 0 };
+		ACCESSOR_COMPONENT_TYPE componentType{ ACCESSOR_COMPONENT_TYPE::FLOAT };
+		bool normalized{ false };
+
+		size_t ElementSize() const noexcept { return SizeOfType(componentType) * componentCount; }
+		bool IsPacked() const noexcept { return stride == ElementSize(); }
+
+		// Element i, starting at its first component
+		unsigned char const* operator[](size_t i) const noexcept { return data + i * stride; }
+
+		// Packed views with a matching layout are a single memcpy, anything else
+		// goes through the conversion kernels. A view without data reads as zero.
+		template <typename T>
+		void CopyTo(std::vector<T>& dst) const noexcept
+		{
+			dst.assign(count, T{});
+			if (data == nullptr || count == 0)
+				return;
+
+			// Never write more lanes than T holds
+			auto const lanes{ std::min(componentCount, sizeof(T) / sizeof(uint32_t)) };
+
+			if constexpr (HAS_FLOAT_COMPONENTS<T>)
+				AccessorConversion::ToFloat(data, stride, componentType, normalized, lanes, count, dst.data(), sizeof(T));
+			else
+				AccessorConversion::ToUint32(data, stride, componentType, lanes, count, dst.data(), sizeof(T));
+		}
+	};
+}
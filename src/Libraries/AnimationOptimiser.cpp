@@ -0,0 +1,217 @@
+/******************************************************************************
+ * \file    AnimationOptimiser.cpp
+ * \author  Loh Xiao Qi
+ * \brief   Error bounded keyframe reduction
+ * 
+ * \copyright	Copyright (c) 2022 Digipen Institute of Technology. Reproduction
+ *						or disclosure of this file or its contents without the prior
+ *						written consent of Digipen Institute of Technology is prohibited
+ ******************************************************************************/
+#include "AnimationOptimiser.h"
+#include "VectorMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+namespace SH_COMP
+{
+  namespace
+  {
+    float InterpolationError(SHVec3 const& from, SHVec3 const& to, float t, SHVec3 const& actual) noexcept
+    {
+      return Distance(Lerp(from, to, t), actual);
+    }
+
+    float InterpolationError(SHVec4 const& from, SHVec4 const& to, float t, SHVec4 const& actual) noexcept
+    {
+      return Angle(Slerp(from, to, t), actual);
+    }
+
+    float HoldError(SHVec3 const& held, SHVec3 const& actual) noexcept
+    {
+      return Distance(held, actual);
+    }
+
+    float HoldError(SHVec4 const& held, SHVec4 const& actual) noexcept
+    {
+      return Angle(held, actual);
+    }
+
+    // True if interpolating keys from and to reproduces every key between them
+    template <typename Key>
+    bool Interpolates(std::vector<Key> const& keys, size_t from, size_t to, float tolerance) noexcept
+    {
+      float const span{ keys[to].time - keys[from].time };
+      for (auto i{ from + 1 }; i < to; ++i)
+      {
+        float const t{ span > 0.f ? (keys[i].time - keys[from].time) / span : 0.f };
+        if (InterpolationError(keys[from].value, keys[to].value, t, keys[i].value) > tolerance)
+          return false;
+      }
+
+      return true;
+    }
+
+    /***************************************************************************
+     * Last key the segment from anchor can reach with every skipped key
+     * within tolerance. The segment is doubled until it fails, then bisected,
+     * so a segment of n keys costs O(n log n) key checks instead of the
+     * O(n²) of extending it one key at a time.
+     *
+     * Whether a segment interpolates is not monotonic in its end, so the
+     * bisection can settle on a different end than the one key at a time
+     * search did, giving slightly different kept keys. Every segment is
+     * still checked in full, so the tolerance always holds.
+     ***************************************************************************/
+    template <typename Key>
+    size_t SegmentEnd(std::vector<Key> const& keys, size_t anchor, float tolerance) noexcept
+    {
+      auto const last{ keys.size() - 1 };
+
+      // Neighbouring keys always reproduce themselves
+      size_t reached{ anchor + 1 };
+      size_t failed{ last + 1 };
+      for (size_t step{ 1 }; reached < last; step *= 2)
+      {
+        auto const end{ std::min(reached + step, last) };
+        if (!Interpolates(keys, anchor, end, tolerance))
+        {
+          failed = end;
+          break;
+        }
+
+        reached = end;
+      }
+
+      while (failed - reached > 1)
+      {
+        auto const end{ reached + (failed - reached) / 2 };
+        if (Interpolates(keys, anchor, end, tolerance))
+          reached = end;
+        else
+          failed = end;
+      }
+
+      return reached;
+    }
+
+    template <typename Key>
+    void ReduceChannel(std::vector<Key>& keys, AnimationInterpolation interpolation, float tolerance) noexcept
+    {
+      auto const count{ keys.size() };
+      if (count <= 2 || interpolation == AnimationInterpolation::CUBICSPLINE)
+        return;
+
+      std::vector<size_t> kept{ 0 };
+      size_t anchor{ 0 };
+
+      if (interpolation == AnimationInterpolation::STEP)
+      {
+        // A key that repeats the held value changes nothing
+        for (size_t i{ 1 }; i < count - 1; ++i)
+        {
+          if (HoldError(keys[anchor].value, keys[i].value) <= tolerance)
+            continue;
+
+          anchor = i;
+          kept.push_back(anchor);
+        }
+
+        kept.push_back(count - 1);
+      }
+      else
+      {
+        // Each segment runs as far as interpolation stays within tolerance
+        while (anchor < count - 1)
+        {
+          anchor = SegmentEnd(keys, anchor, tolerance);
+          kept.push_back(anchor);
+        }
+      }
+
+      std::vector<Key> result;
+      result.reserve(kept.size());
+      for (auto const i : kept)
+        result.push_back(keys[i]);
+
+      keys = std::move(result);
+    }
+
+    size_t NodeKeyCount(AnimNode const& node) noexcept
+    {
+      return node.positionKeys.size() + node.rotationKeys.size() + node.scaleKeys.size();
+    }
+  }
+
+  size_t AnimationOptimiser::ReduceKeys(AnimNode& node, KeyframeTolerance const& tolerance) noexcept
+  {
+    ReduceChannel(node.positionKeys, node.interpolation, tolerance.position);
+    ReduceChannel(node.rotationKeys, node.interpolation, tolerance.rotation);
+    ReduceChannel(node.scaleKeys, node.interpolation, tolerance.scale);
+
+    return NodeKeyCount(node);
+  }
+
+  size_t AnimationOptimiser::ReduceKeys(AnimData& anim, KeyframeTolerance const& tolerance) noexcept
+  {
+    size_t kept{ 0 };
+    for (auto& node : anim.nodes)
+      kept += ReduceKeys(node, tolerance);
+
+    return kept;
+  }
+
+  size_t AnimationOptimiser::CountKeys(AnimData const& anim) noexcept
+  {
+    size_t count{ 0 };
+    for (auto const& node : anim.nodes)
+      count += NodeKeyCount(node);
+
+    return count;
+  }
+
+  void AnimationOptimiser::ShareTimelines(AnimData& anim) noexcept
+  {
+    anim.timelines.clear();
+    anim.times.clear();
+    anim.nodeHeaders.clear();
+    anim.nodeHeaders.reserve(anim.nodes.size());
+
+    std::map<std::vector<float>, uint32_t> timelineIndices;
+    uint32_t positionCount{ 0 }, rotationCount{ 0 }, scaleCount{ 0 };
+
+    for (size_t i{ 0 }; i < anim.nodes.size(); ++i)
+    {
+      auto const& node{ anim.nodes[i] };
+      auto const constant{ anim.quantisedNodes.empty() ? AnimChannelFlag{ 0 } : anim.quantisedNodes[i].constantChannels };
+
+      auto const share = [&](auto const& keys, AnimChannelFlag channel, uint32_t& valueCount) -> AnimChannel
+      {
+        if (keys.empty() || (constant & channel))
+          return { NO_TIMELINE, 0 };
+
+        std::vector<float> times(keys.size());
+        std::ranges::transform(keys, times.begin(), [](KeyBase const& key) { return key.time; });
+
+        auto const [timeline, added] { timelineIndices.try_emplace(std::move(times), static_cast<uint32_t>(anim.timelines.size())) };
+        if (added)
+        {
+          anim.timelines.push_back({ static_cast<uint32_t>(anim.times.size()), static_cast<uint32_t>(keys.size()) });
+          anim.times.insert(anim.times.end(), timeline->first.begin(), timeline->first.end());
+        }
+
+        AnimChannel const result{ timeline->second, valueCount };
+        valueCount += static_cast<uint32_t>(keys.size());
+        return result;
+      };
+
+      AnimNodeHeader header{};
+      header.position = share(node.positionKeys, ANIM_CHANNEL_POSITION, positionCount);
+      header.rotation = share(node.rotationKeys, ANIM_CHANNEL_ROTATION, rotationCount);
+      header.scale = share(node.scaleKeys, ANIM_CHANNEL_SCALE, scaleCount);
+      header.interpolation = node.interpolation;
+      anim.nodeHeaders.push_back(header);
+    }
+  }
+}
@@ -0,0 +1,44 @@
+/******************************************************************************
+ * \file    AnimationOptimiser.h
+ * \author  Loh Xiao Qi
+ * \brief   Optional passes run over compiled AnimData before headers are
+ *					built, to cut clip memory and sampling cost
+ * 
+ * \copyright	Copyright (c) 2022 Digipen Institute of Technology. Reproduction
+ *						or disclosure of this file or its contents without the prior
+ *						written consent of Digipen Institute of Technology is prohibited
+ ******************************************************************************/
+#pragma once
+
+#include "CompileOptions.h"
+#include "Types/AnimationAsset.h"
+
+namespace SH_COMP
+{
+	struct AnimationOptimiser
+	{
+		/*************************************************************************
+		 * Drops every key whose value is reproduced by interpolating its kept
+		 * neighbours to within tolerance, measured against the source keys so
+		 * errors do not accumulate. Each channel is reduced on its own and
+		 * keeps its first and last keys. CUBICSPLINE nodes are not reduced.
+		 * Returns the number of keys kept, counting each channel.
+		 *************************************************************************/
+		static size_t ReduceKeys(AnimNode& node, KeyframeTolerance const& tolerance) noexcept;
+
+		// ReduceKeys over every node of the clip
+		static size_t ReduceKeys(AnimData& anim, KeyframeTolerance const& tolerance) noexcept;
+
+		// Position, rotation and scale keys of the clip, counting each channel
+		static size_t CountKeys(AnimData const& anim) noexcept;
+
+		/*************************************************************************
+		 * Builds the clip's timelines, time array and node headers. Channels
+		 * with identical key times share one timeline, which covers every
+		 * channel driven by the same sampler input. Values are laid out per
+		 * channel type in node order. Runs after quantisation, as constant
+		 * channels get no timeline.
+		 *************************************************************************/
+		static void ShareTimelines(AnimData& anim) noexcept;
+	};
+}
@@ -0,0 +1,133 @@
+/******************************************************************************
+ * \file    AnimationSampler.cpp
+ * \author  Loh Xiao Qi
+ * \brief   Evaluation of gltf animation samplers
+ *
+ * \copyright	Copyright (c) 2022 Digipen Institute of Technology. Reproduction
+ *						or disclosure of this file or its contents without the prior
+ *						written consent of Digipen Institute of Technology is prohibited
+ ******************************************************************************/
+#include "AnimationSampler.h"
+#include "VectorMath.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace SH_COMP
+{
+  namespace
+  {
+    // Sample positions this close to a whole sample are rounded to it, so
+    // float durations such as 1.0000001s do not add a sample
+    constexpr double SAMPLE_EPSILON{ 1e-3 };
+
+    SHVec4 Weigh(SHVec4 const& a, float aWeight, SHVec4 const& b, float bWeight) noexcept
+    {
+      return {
+        a.x * aWeight + b.x * bWeight,
+        a.y * aWeight + b.y * bWeight,
+        a.z * aWeight + b.z * bWeight,
+        a.w * aWeight + b.w * bWeight
+      };
+    }
+
+    // Outputs per key for the curve's interpolation mode
+    size_t Stride(AnimationSampler::Curve const& curve) noexcept
+    {
+      return curve.interpolation == AnimationInterpolation::CUBICSPLINE ? 3 : 1;
+    }
+
+    size_t KeyCount(AnimationSampler::Curve const& curve) noexcept
+    {
+      return std::min(curve.times.size(), curve.outputs.size() / Stride(curve));
+    }
+
+    SHVec4 const& Value(AnimationSampler::Curve const& curve, size_t key) noexcept
+    {
+      return curve.interpolation == AnimationInterpolation::CUBICSPLINE ?
+        curve.outputs[key * 3 + 1] : curve.outputs[key];
+    }
+
+    // Between keys key and key + 1, at t in [0, 1]
+    SHVec4 Interpolate(AnimationSampler::Curve const& curve, bool rotation, size_t key, float t) noexcept
+    {
+      auto const& from{ Value(curve, key) };
+      auto const& to{ Value(curve, key + 1) };
+
+      switch (curve.interpolation)
+      {
+      case AnimationInterpolation::STEP:
+        return from;
+
+      case AnimationInterpolation::CUBICSPLINE:
+      {
+        // Hermite spline with the tangents scaled by the key interval
+        float const interval{ curve.times[key + 1] - curve.times[key] };
+        float const t2{ t * t };
+        float const t3{ t2 * t };
+
+        auto const& outTangent{ curve.outputs[key * 3 + 2] };
+        auto const& inTangent{ curve.outputs[(key + 1) * 3] };
+
+        auto const value{ Weigh(
+          Weigh(from, 2.f * t3 - 3.f * t2 + 1.f, outTangent, interval * (t3 - 2.f * t2 + t)),
+          1.f,
+          Weigh(to, -2.f * t3 + 3.f * t2, inTangent, interval * (t3 - t2)),
+          1.f
+        ) };
+
+        return rotation ? Normalise(value) : value;
+      }
+
+      default:
+        return rotation ? Normalise(Slerp(from, to, t)) : Weigh(from, 1.f - t, to, t);
+      }
+    }
+  }
+
+  std::vector<SHVec4> AnimationSampler::KeyValues(Curve const& curve) noexcept
+  {
+    std::vector<SHVec4> values(KeyCount(curve));
+    for (size_t i{ 0 }; i < values.size(); ++i)
+      values[i] = Value(curve, i);
+
+    return values;
+  }
+
+  uint32_t AnimationSampler::SampleCount(double duration, float rate) noexcept
+  {
+    double const samples{ std::max(duration, 0.0) * rate };
+    return static_cast<uint32_t>(std::ceil(samples - SAMPLE_EPSILON)) + 1;
+  }
+
+  std::vector<SHVec4> AnimationSampler::Resample(Curve const& curve, bool rotation, float rate, uint32_t count) noexcept
+  {
+    auto const keyCount{ KeyCount(curve) };
+    if (keyCount == 0)
+      return {};
+
+    std::vector<SHVec4> samples(count);
+
+    // Sample times only increase, so the segment is found by walking forward
+    size_t key{ 0 };
+    for (uint32_t i{ 0 }; i < count; ++i)
+    {
+      float const time{ static_cast<float>(static_cast<double>(i) / rate) };
+      while (key + 1 < keyCount && curve.times[key + 1] <= time)
+        ++key;
+
+      if (key + 1 == keyCount || time <= curve.times[key])
+      {
+        samples[i] = Value(curve, key);
+        if (rotation)
+          samples[i] = Normalise(samples[i]);
+        continue;
+      }
+
+      float const t{ (time - curve.times[key]) / (curve.times[key + 1] - curve.times[key]) };
+      samples[i] = Interpolate(curve, rotation, key, t);
+    }
+
+    return samples;
+  }
+}
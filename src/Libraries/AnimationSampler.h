@@ -0,0 +1,49 @@
+/******************************************************************************
+ * \file    AnimationSampler.h
+ * \author  Loh Xiao Qi
+ * \brief   Evaluation of gltf animation samplers, used to read their key
+ *					values and to bake them to a uniform sample rate
+ *
+ * \copyright	Copyright (c) 2022 Digipen Institute of Technology. Reproduction
+ *						or disclosure of this file or its contents without the prior
+ *						written consent of Digipen Institute of Technology is prohibited
+ ******************************************************************************/
+#pragma once
+
+#include <vector>
+
+#include "Types/AnimationAsset.h"
+
+namespace SH_COMP
+{
+	struct AnimationSampler
+	{
+		/*************************************************************************
+		 * Key times and outputs of one gltf sampler, in seconds. CUBICSPLINE
+		 * outputs hold an in tangent, value and out tangent per key, in that
+		 * order, other modes hold one value per key. Positions and scales
+		 * leave w unused.
+		 *************************************************************************/
+		struct Curve
+		{
+			std::vector<float> times;
+			std::vector<SHVec4> outputs;
+			AnimationInterpolation interpolation;
+		};
+
+		// Value of every key, without the tangents of CUBICSPLINE curves
+		static std::vector<SHVec4> KeyValues(Curve const& curve) noexcept;
+
+		// Samples at rate per second that cover [0, duration]. The last one
+		// lies past duration unless the clip ends on a whole sample.
+		static uint32_t SampleCount(double duration, float rate) noexcept;
+
+		/*************************************************************************
+		 * Evaluates the curve at sample / rate seconds for each sample below
+		 * count, as gltf specifies for its interpolation mode. Times before
+		 * the first key or after the last hold that key's value. Rotations
+		 * are slerped and normalised.
+		 *************************************************************************/
+		static std::vector<SHVec4> Resample(Curve const& curve, bool rotation, float rate, uint32_t count) noexcept;
+	};
+}
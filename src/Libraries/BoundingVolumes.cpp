@@ -0,0 +1,142 @@
+/******************************************************************************
+ * \file    BoundingVolumes.cpp
+ * \author  Loh Xiao Qi
+ * \brief   Bounding volume construction over vertex positions
+ * 
+ * \copyright	Copyright (c) 2022 Digipen Institute of Technology. Reproduction
+ *						or disclosure of this file or its contents without the prior
+ *						written consent of Digipen Institute of Technology is prohibited
+ ******************************************************************************/
+#include "BoundingVolumes.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace SH_COMP
+{
+  namespace
+  {
+    float DistanceSquared(SHVec3 const& a, SHVec3 const& b) noexcept
+    {
+      auto const x{ a.x - b.x }, y{ a.y - b.y }, z{ a.z - b.z };
+      return x * x + y * y + z * z;
+    }
+  }
+
+  BoundingBox BoundingVolumes::ComputeBox(std::vector<SHVec3> const& positions) noexcept
+  {
+    if (positions.empty())
+      return {};
+
+    BoundingBox box{ positions[0], positions[0] };
+    for (auto const& position : positions)
+    {
+      box.min.x = std::min(box.min.x, position.x);
+      box.min.y = std::min(box.min.y, position.y);
+      box.min.z = std::min(box.min.z, position.z);
+      box.max.x = std::max(box.max.x, position.x);
+      box.max.y = std::max(box.max.y, position.y);
+      box.max.z = std::max(box.max.z, position.z);
+    }
+
+    return box;
+  }
+
+  BoundingSphere BoundingVolumes::ComputeSphere(std::vector<SHVec3> const& positions, std::span<uint32_t const> indices) noexcept
+  {
+    auto const count{ indices.empty() ? positions.size() : indices.size() };
+    auto const at = [&](size_t i)->SHVec3 const&
+    {
+      return positions[indices.empty() ? i : indices[i]];
+    };
+
+    if (count == 0)
+      return { SHVec3{}, 0.f };
+
+    auto const farthestFrom = [&](SHVec3 const& origin)->SHVec3 const&
+    {
+      size_t best{ 0 };
+      float bestDistance{ -1.f };
+      for (size_t i{ 0 }; i < count; ++i)
+      {
+        auto const distance{ DistanceSquared(at(i), origin) };
+        if (distance > bestDistance)
+        {
+          bestDistance = distance;
+          best = i;
+        }
+      }
+      return at(best);
+    };
+
+    // Initial sphere spans an approximate diameter
+    auto const& a{ farthestFrom(at(0)) };
+    auto const& b{ farthestFrom(a) };
+
+    BoundingSphere sphere{
+      SHVec3{ (a.x + b.x) * 0.5f, (a.y + b.y) * 0.5f, (a.z + b.z) * 0.5f },
+      0.f
+    };
+    sphere.radius = std::sqrt(DistanceSquared(a, sphere.center));
+
+    // Grow towards every point still outside
+    for (size_t i{ 0 }; i < count; ++i)
+    {
+      auto const& point{ at(i) };
+      auto const distanceSquared{ DistanceSquared(point, sphere.center) };
+      if (distanceSquared <= sphere.radius * sphere.radius)
+        continue;
+
+      auto const distance{ std::sqrt(distanceSquared) };
+      auto const newRadius{ (sphere.radius + distance) * 0.5f };
+      auto const shift{ (newRadius - sphere.radius) / distance };
+
+      sphere.center.x += (point.x - sphere.center.x) * shift;
+      sphere.center.y += (point.y - sphere.center.y) * shift;
+      sphere.center.z += (point.z - sphere.center.z) * shift;
+      sphere.radius = newRadius;
+    }
+
+    return sphere;
+  }
+
+  BoundingSphere BoundingVolumes::SphereOfBox(BoundingBox const& box) noexcept
+  {
+    SHVec3 const center{
+      (box.min.x + box.max.x) * 0.5f,
+      (box.min.y + box.max.y) * 0.5f,
+      (box.min.z + box.max.z) * 0.5f
+    };
+
+    return { center, std::sqrt(DistanceSquared(box.max, center)) };
+  }
+
+  BoundingBox BoundingVolumes::Merge(BoundingBox const& lhs, BoundingBox const& rhs) noexcept
+  {
+    return {
+      SHVec3{ std::min(lhs.min.x, rhs.min.x), std::min(lhs.min.y, rhs.min.y), std::min(lhs.min.z, rhs.min.z) },
+      SHVec3{ std::max(lhs.max.x, rhs.max.x), std::max(lhs.max.y, rhs.max.y), std::max(lhs.max.z, rhs.max.z) }
+    };
+  }
+
+  BoundingSphere BoundingVolumes::Merge(BoundingSphere const& lhs, BoundingSphere const& rhs) noexcept
+  {
+    auto const distance{ std::sqrt(DistanceSquared(lhs.center, rhs.center)) };
+    if (distance + rhs.radius <= lhs.radius)
+      return lhs;
+    if (distance + lhs.radius <= rhs.radius)
+      return rhs;
+
+    auto const radius{ (distance + lhs.radius + rhs.radius) * 0.5f };
+    auto const shift{ (radius - lhs.radius) / distance };
+
+    return {
+      SHVec3{
+        lhs.center.x + (rhs.center.x - lhs.center.x) * shift,
+        lhs.center.y + (rhs.center.y - lhs.center.y) * shift,
+        lhs.center.z + (rhs.center.z - lhs.center.z) * shift
+      },
+      radius
+    };
+  }
+}
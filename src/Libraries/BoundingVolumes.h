@@ -0,0 +1,35 @@
+/******************************************************************************
+ * \file    BoundingVolumes.h
+ * \author  Loh Xiao Qi
+ * \brief   Bounding volume construction over vertex positions
+ * 
+ * \copyright	Copyright (c) 2022 Digipen Institute of Technology. Reproduction
+ *						or disclosure of this file or its contents without the prior
+ *						written consent of Digipen Institute of Technology is prohibited
+ ******************************************************************************/
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "Types/MeshAsset.h"
+
+namespace SH_COMP
+{
+	struct BoundingVolumes
+	{
+		static BoundingBox ComputeBox(std::vector<SHVec3> const& positions) noexcept;
+
+		// Ritter's sphere over positions[indices[i]], or every position when
+		// indices is empty
+		static BoundingSphere ComputeSphere(std::vector<SHVec3> const& positions, std::span<uint32_t const> indices = {}) noexcept;
+
+		// Circumscribed sphere of the box
+		static BoundingSphere SphereOfBox(BoundingBox const& box) noexcept;
+
+		static BoundingBox Merge(BoundingBox const& lhs, BoundingBox const& rhs) noexcept;
+
+		// Smallest sphere enclosing both
+		static BoundingSphere Merge(BoundingSphere const& lhs, BoundingSphere const& rhs) noexcept;
+	};
+}
@@ -0,0 +1,200 @@
+/******************************************************************************
+ * \file    BuildCache.cpp
+ * \author  Loh Xiao Qi
+ * \brief   Content hash cache used to skip recompiling unchanged assets
+ * 
+ * \copyright	Copyright (c) 2022 Digipen Institute of Technology. Reproduction
+ *						or disclosure of this file or its contents without the prior
+ *						written consent of Digipen Institute of Technology is prohibited
+ ******************************************************************************/
+#include "BuildCache.h"
+#include "MeshWriter.h"
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <iterator>
+
+#include "Includes/json.hpp"
+
+// Declarations only, the implementation is compiled with MeshCompiler
+#undef TINYGLTF_IMPLEMENTATION
+#include "Includes/tiny_gltf.h"
+
+namespace SH_COMP
+{
+  // FNV-1a, 64 bit
+  constexpr CacheKey HASH_SEED{ 0xcbf29ce484222325ull };
+  constexpr CacheKey HASH_PRIME{ 0x100000001b3ull };
+
+  constexpr size_t HASH_CHUNK_SIZE{ 1 << 20 };
+
+  CacheKey BuildCache::ComputeKey(AssetPath path, CompileOptions const& options, std::ostream& log) noexcept
+  {
+    CacheKey hash{ HASH_SEED };
+
+    HashBytes(&MODEL_COMPILER_VERSION, sizeof(MODEL_COMPILER_VERSION), hash);
+
+    if (!HashFile(path, hash) || !HashReferencedBuffers(path, hash, log))
+      return INVALID_KEY;
+
+    HashBytes(&options.weldVertices, sizeof(options.weldVertices), hash);
+    HashBytes(&options.weldEpsilon, sizeof(options.weldEpsilon), hash);
+    HashBytes(&options.optimiseVertexCache, sizeof(options.optimiseVertexCache), hash);
+    HashBytes(&options.optimiseVertexFetch, sizeof(options.optimiseVertexFetch), hash);
+    HashBytes(&options.quantisePositions, sizeof(options.quantisePositions), hash);
+    HashBytes(&options.quantiseNormals, sizeof(options.quantiseNormals), hash);
+    HashBytes(&options.quantiseTexCoords, sizeof(options.quantiseTexCoords), hash);
+    HashBytes(&options.compactSkinning, sizeof(options.compactSkinning), hash);
+    HashBytes(&options.skinWeightBits, sizeof(options.skinWeightBits), hash);
+    HashBytes(&options.buildMeshlets, sizeof(options.buildMeshlets), hash);
+    HashBytes(&options.meshletMaxVertices, sizeof(options.meshletMaxVertices), hash);
+    HashBytes(&options.meshletMaxTriangles, sizeof(options.meshletMaxTriangles), hash);
+    HashBytes(options.lodRatios.data(), sizeof(float) * options.lodRatios.size(), hash);
+    HashBytes(&options.lodMaxError, sizeof(options.lodMaxError), hash);
+    HashBytes(&options.reduceKeyframes, sizeof(options.reduceKeyframes), hash);
+    HashBytes(&options.keyTolerance, sizeof(options.keyTolerance), hash);
+    for (auto const& [clip, tolerance] : options.clipKeyTolerances)
+    {
+      HashBytes(clip.data(), clip.size() + 1, hash);
+      HashBytes(&tolerance, sizeof(tolerance), hash);
+    }
+    HashBytes(&options.quantiseKeys, sizeof(options.quantiseKeys), hash);
+    HashBytes(&options.keyQuantisationBudget, sizeof(options.keyQuantisationBudget), hash);
+    for (auto const& clip : options.quantisedClips)
+      HashBytes(clip.data(), clip.size() + 1, hash);
+    HashBytes(&options.sampleRate, sizeof(options.sampleRate), hash);
+    for (auto const& [clip, rate] : options.clipSampleRates)
+    {
+      HashBytes(clip.data(), clip.size() + 1, hash);
+      HashBytes(&rate, sizeof(rate), hash);
+    }
+
+    return hash == INVALID_KEY ? INVALID_KEY + 1 : hash;
+  }
+
+  bool BuildCache::IsUpToDate(AssetPath path, CacheKey key) noexcept
+  {
+    if (key == INVALID_KEY)
+      return false;
+
+    std::ifstream file{ GetCachePath(path) };
+    CacheKey storedKey{ INVALID_KEY }, storedOutput{ INVALID_KEY };
+    if (!(file >> std::hex >> storedKey >> storedOutput) || storedKey != key)
+      return false;
+
+    // Output must still be exactly what was written last time
+    CacheKey outputHash{ HASH_SEED };
+    return HashFile(MeshWriter::GetOutputPath(path), outputHash) && outputHash == storedOutput;
+  }
+
+  void BuildCache::Store(AssetPath path, CacheKey key) noexcept
+  {
+    auto const cachePath{ GetCachePath(path) };
+    CacheKey outputHash{ HASH_SEED };
+
+    if (key == INVALID_KEY || !HashFile(MeshWriter::GetOutputPath(path), outputHash))
+    {
+      std::error_code ec;
+      std::filesystem::remove(cachePath, ec);
+      return;
+    }
+
+    std::ofstream file{ cachePath, std::ios::out | std::ios::trunc };
+    file << std::hex << key << ' ' << outputHash << '\n';
+  }
+
+  bool BuildCache::HashFile(AssetPath path, CacheKey& hash) noexcept
+  {
+    std::ifstream file{ path, std::ios::in | std::ios::binary };
+    if (!file.is_open())
+      return false;
+
+    std::vector<char> chunk(HASH_CHUNK_SIZE);
+    while (file)
+    {
+      file.read(chunk.data(), chunk.size());
+      HashBytes(chunk.data(), static_cast<size_t>(file.gcount()), hash);
+    }
+
+    return file.eof();
+  }
+
+  bool BuildCache::HashReferencedBuffers(AssetPath path, CacheKey& hash, std::ostream& log) noexcept
+  {
+    auto const extension{ path.extension().string() };
+    if (extension != GLTF_EXTENSION && extension != GLB_EXTENSION)
+      return true;
+
+    std::ifstream file{ path, std::ios::in | std::ios::binary };
+    std::string text;
+    if (extension == GLB_EXTENSION)
+    {
+      // 12 byte file header followed by the JSON chunk length and type
+      uint32_t glbHeader[5]{};
+      if (!file.read(reinterpret_cast<char*>(glbHeader), sizeof(glbHeader)) ||
+        glbHeader[4] != GLB_CHUNK_JSON)
+        return false;
+
+      // A corrupt chunk length must not size the allocation
+      std::error_code ec;
+      auto const fileSize{ std::filesystem::file_size(path, ec) };
+      if (ec || glbHeader[3] > fileSize - sizeof(glbHeader))
+        return false;
+
+      text.resize(glbHeader[3]);
+      file.read(text.data(), text.size());
+    }
+    else
+    {
+      text.assign(std::istreambuf_iterator<char>{ file }, {});
+    }
+
+    auto const json = nlohmann::json::parse(text, nullptr, false);
+    if (json.is_discarded())
+      return false;
+
+    auto const buffers{ json.find("buffers") };
+    if (buffers == json.end() || !buffers->is_array())
+      return true;
+
+    for (auto const& buffer : *buffers)
+    {
+      auto const uri{ buffer.find("uri") };
+      if (uri == buffer.end() || !uri->is_string())
+        continue;
+
+      // Embedded and BIN chunk buffers are already covered by the file hash
+      auto const& uriString{ uri->get_ref<std::string const&>() };
+      if (uriString.starts_with("data:"))
+        continue;
+
+      // Decoded as the loader does, exporters write names with spaces as %20
+      std::string decodedUri;
+      tinygltf::URIDecode(uriString, &decodedUri, nullptr);
+      if (!HashFile(path.parent_path() / decodedUri, hash))
+      {
+        log << "[Model Compiler] Could not hash buffer " << decodedUri << " of " << path << ", it will be recompiled every run\n";
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  void BuildCache::HashBytes(void const* data, size_t size, CacheKey& hash) noexcept
+  {
+    auto const bytes{ static_cast<unsigned char const*>(data) };
+    for (size_t i{ 0 }; i < size; ++i)
+    {
+      hash ^= bytes[i];
+      hash *= HASH_PRIME;
+    }
+  }
+
+  AssetPath BuildCache::GetCachePath(AssetPath path) noexcept
+  {
+    return path.replace_extension(BUILD_CACHE_EXTENSION);
+  }
+}
@@ -0,0 +1,41 @@
+/******************************************************************************
+ * \file    BuildCache.h
+ * \author  Loh Xiao Qi
+ * \brief   Content hash cache used to skip recompiling unchanged assets.
+ *					Each compiled .shmodel gets a small sidecar file recording the
+ *					hash of its inputs and of the output that was written.
+ * 
+ * \copyright	Copyright (c) 2022 Digipen Institute of Technology. Reproduction
+ *						or disclosure of this file or its contents without the prior
+ *						written consent of Digipen Institute of Technology is prohibited
+ ******************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+#include "AssetMacros.h"
+#include "CompileOptions.h"
+
+namespace SH_COMP
+{
+	using CacheKey = uint64_t;
+
+	struct BuildCache
+	{
+		// Returned when an input could not be read, never matches a stored key
+		static constexpr CacheKey INVALID_KEY{ 0 };
+
+		static CacheKey ComputeKey(AssetPath path, CompileOptions const& options, std::ostream& log) noexcept;
+
+		static bool IsUpToDate(AssetPath path, CacheKey key) noexcept;
+		static void Store(AssetPath path, CacheKey key) noexcept;
+
+	private:
+		static bool HashFile(AssetPath path, CacheKey& hash) noexcept;
+		static bool HashReferencedBuffers(AssetPath path, CacheKey& hash, std::ostream& log) noexcept;
+		static void HashBytes(void const* data, size_t size, CacheKey& hash) noexcept;
+
+		static AssetPath GetCachePath(AssetPath path) noexcept;
+	};
+}
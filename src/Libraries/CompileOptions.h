@@ -0,0 +1,106 @@
+/******************************************************************************
+ * \file    CompileOptions.h
+ * \author  Loh Xiao Qi
+ * \brief   Settings shared by every compile job in a single run
+ * 
+ * \copyright	Copyright (c) 2022 Digipen Institute of Technology. Reproduction
+ *						or disclosure of this file or its contents without the prior
+ *						written consent of Digipen Institute of Technology is prohibited
+ ******************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace SH_COMP
+{
+	// Largest error a dropped key may introduce on each channel
+	struct KeyframeTolerance
+	{
+		// Distance in model units
+		float position{ 1e-4f };
+		// Angle in radians
+		float rotation{ 1e-3f };
+		float scale{ 1e-4f };
+	};
+
+	// Any field that changes the compiled output must also be folded into
+	// BuildCache::ComputeKey, otherwise stale files will be reused.
+	struct CompileOptions
+	{
+		// Skip files whose source hash matches the last successful compile
+		bool useCache{ true };
+
+		// Read every written file back through ModelView with full validation
+		// and log how long the validated load took. LoadBenchmark times plain
+		// loads. Does not change the output.
+		bool verifyOutput{ false };
+
+		// Threads one compile job may use within its own passes, so parallel
+		// jobs do not oversubscribe the machine. 0 uses every hardware thread.
+		// Does not change the output.
+		uint32_t threadsPerJob{ 0 };
+
+		// Read .bin/.glb payloads through a file mapping instead of letting
+		// tinygltf copy them into memory
+		bool mapSourceBuffers{ true };
+
+		// Collapse duplicate vertices. Above 0, float components closer than
+		// weldEpsilon are treated as equal instead of requiring identical bits
+		bool weldVertices{ false };
+		float weldEpsilon{ 0.f };
+
+		// Reorder triangles for post transform vertex cache locality
+		bool optimiseVertexCache{ false };
+
+		// Reorder vertex streams into first use order of the index buffer
+		bool optimiseVertexFetch{ false };
+
+		// Compact vertex encodings, see VERTEX_ENCODING_* in MeshAsset.h
+		bool quantisePositions{ false };
+		bool quantiseNormals{ false };
+		bool quantiseTexCoords{ false };
+
+		// Joints as u8x4/u16x4 and weights as renormalised unorm of
+		// skinWeightBits (8 or 16) per component
+		bool compactSkinning{ false };
+		uint32_t skinWeightBits{ 8 };
+
+		// Split each submesh into meshlets of at most this many vertices and
+		// triangles, see MeshletBuilder
+		bool buildMeshlets{ false };
+		uint32_t meshletMaxVertices{ 64 };
+		uint32_t meshletMaxTriangles{ 124 };
+
+		// One simplified LOD per entry, as a fraction of the full triangle
+		// count. Simplification stops at lodMaxError, relative to the largest
+		// mesh extent. Empty disables LOD generation.
+		std::vector<float> lodRatios;
+		float lodMaxError{ 0.01f };
+
+		// Drop animation keys that interpolating their neighbours reproduces
+		// within keyTolerance, see AnimationOptimiser. Clips named in
+		// clipKeyTolerances use that tolerance instead.
+		bool reduceKeyframes{ false };
+		KeyframeTolerance keyTolerance;
+		std::map<std::string, KeyframeTolerance> clipKeyTolerances;
+
+		// Write clips with KEY_ENCODING_QUANTISED, see KeyQuantisation. A clip
+		// whose measured error exceeds keyQuantisationBudget stays at full
+		// precision. If quantisedClips is not empty, only the clips it names
+		// are quantised.
+		bool quantiseKeys{ false };
+		KeyframeTolerance keyQuantisationBudget;
+		std::set<std::string> quantisedClips;
+
+		// Bake every animation channel to keys at sampleRate per second, so a
+		// key is found by index, see AnimationSampler. Clips named in
+		// clipSampleRates use that rate instead. 0 keeps the source keys.
+		// Resampled clips are not key reduced.
+		float sampleRate{ 0.f };
+		std::map<std::string, float> clipSampleRates;
+	};
+}
@@ -0,0 +1,260 @@
+/******************************************************************************
+ * \file    KeyQuantisation.cpp
+ * \author  Loh Xiao Qi
+ * \brief   Encoders for the KEY_ENCODING_QUANTISED animation format in
+ *					AnimationAsset.h
+ * 
+ * \copyright	Copyright (c) 2022 Digipen Institute of Technology. Reproduction
+ *						or disclosure of this file or its contents without the prior
+ *						written consent of Digipen Institute of Technology is prohibited
+ ******************************************************************************/
+#include "KeyQuantisation.h"
+#include "VectorMath.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace SH_COMP
+{
+  namespace
+  {
+    constexpr float UNORM15_MAX{ 32767.f };
+    constexpr float SQRT_2{ 1.41421356f };
+
+    // True if the channel collapses to offset, otherwise offset and scale map
+    // the key range onto unorm16. Empty channels are not animated, and are
+    // neither.
+    template <typename Key>
+    bool ComputeRange(std::vector<Key> const& keys, float tolerance, SHVec3& offset, SHVec3& scale) noexcept
+    {
+      scale = SHVec3{};
+      if (keys.empty())
+        return false;
+
+      auto min{ keys[0].value }, max{ keys[0].value };
+      for (auto const& key : keys)
+      {
+        min.x = std::min(min.x, key.value.x);
+        min.y = std::min(min.y, key.value.y);
+        min.z = std::min(min.z, key.value.z);
+        max.x = std::max(max.x, key.value.x);
+        max.y = std::max(max.y, key.value.y);
+        max.z = std::max(max.z, key.value.z);
+      }
+
+      // The centre of the range is at most half its diagonal from any key
+      if (Distance(min, max) * 0.5f <= tolerance)
+      {
+        offset = { (min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f, (min.z + max.z) * 0.5f };
+        return true;
+      }
+
+      offset = min;
+      scale = { (max.x - min.x) / UNORM16_MAX, (max.y - min.y) / UNORM16_MAX, (max.z - min.z) / UNORM16_MAX };
+      return false;
+    }
+
+    template <typename Key>
+    std::vector<QuantisedVector> EncodeVectors(std::vector<Key> const& keys, SHVec3 const& offset, SHVec3 const& scale) noexcept
+    {
+      std::vector<QuantisedVector> result(keys.size());
+      std::ranges::transform(
+        keys,
+        result.begin(),
+        [&offset, &scale](Key const& key)->QuantisedVector
+        {
+          return {
+            ToUnorm16(key.value.x, offset.x, scale.x),
+            ToUnorm16(key.value.y, offset.y, scale.y),
+            ToUnorm16(key.value.z, offset.z, scale.z)
+          };
+        }
+      );
+
+      return result;
+    }
+
+    template <typename Key>
+    float VectorError(std::vector<Key> const& keys, SHVec3 const& offset, SHVec3 const& scale, bool constant) noexcept
+    {
+      auto const encoded{ EncodeVectors(keys, offset, scale) };
+      float error{ 0.f };
+      for (size_t i{ 0 }; i < keys.size(); ++i)
+      {
+        auto const value{ constant ? offset : KeyQuantisation::DecodeVector(encoded[i], offset, scale) };
+        error = std::max(error, Distance(value, keys[i].value));
+      }
+
+      return error;
+    }
+  }
+
+  QuantisedNodeHeader KeyQuantisation::ComputeNodeHeader(AnimNode const& node, KeyframeTolerance const& budget) noexcept
+  {
+    QuantisedNodeHeader header{};
+
+    if (ComputeRange(node.positionKeys, budget.position, header.positionOffset, header.positionScale))
+      header.constantChannels |= ANIM_CHANNEL_POSITION;
+
+    if (ComputeRange(node.scaleKeys, budget.scale, header.scaleOffset, header.scaleScale))
+      header.constantChannels |= ANIM_CHANNEL_SCALE;
+
+    auto const& rotations{ node.rotationKeys };
+    header.rotation = rotations.empty() ? IDENTITY_ROTATION : Normalise(rotations[0].value);
+    if (!rotations.empty() &&
+      std::ranges::all_of(rotations, [&](RotationKey const& key) { return Angle(key.value, header.rotation) <= budget.rotation; }))
+    {
+      header.constantChannels |= ANIM_CHANNEL_ROTATION;
+    }
+
+    return header;
+  }
+
+  std::vector<QuantisedVector> KeyQuantisation::EncodePositions(std::vector<PositionKey> const& keys, QuantisedNodeHeader const& header) noexcept
+  {
+    return EncodeVectors(keys, header.positionOffset, header.positionScale);
+  }
+
+  std::vector<QuantisedVector> KeyQuantisation::EncodeScales(std::vector<ScaleKey> const& keys, QuantisedNodeHeader const& header) noexcept
+  {
+    return EncodeVectors(keys, header.scaleOffset, header.scaleScale);
+  }
+
+  std::vector<QuantisedRotation> KeyQuantisation::EncodeRotations(std::vector<RotationKey> const& keys) noexcept
+  {
+    std::vector<QuantisedRotation> result(keys.size());
+    std::ranges::transform(
+      keys,
+      result.begin(),
+      [](RotationKey const& key)->QuantisedRotation
+      {
+        auto const rotation{ Normalise(key.value) };
+        std::array<float, 4> components{ rotation.x, rotation.y, rotation.z, rotation.w };
+
+        auto const largest{ static_cast<uint64_t>(std::ranges::max_element(components, {}, [](float c) { return std::abs(c); }) - components.begin()) };
+
+        // q and -q are the same rotation, keeping the largest positive lets
+        // the decoder rebuild it without a sign bit
+        float const sign{ components[largest] < 0.f ? -1.f : 1.f };
+
+        uint64_t bits{ largest << 45 };
+        uint32_t shift{ 0 };
+        for (uint64_t i{ 0 }; i < components.size(); ++i)
+        {
+          if (i == largest)
+            continue;
+
+          auto const normalised{ std::clamp((components[i] * sign * SQRT_2 + 1.f) * 0.5f, 0.f, 1.f) };
+          bits |= static_cast<uint64_t>(std::lround(normalised * UNORM15_MAX)) << shift;
+          shift += 15;
+        }
+
+        return { {
+          static_cast<uint16_t>(bits),
+          static_cast<uint16_t>(bits >> 16),
+          static_cast<uint16_t>(bits >> 32)
+        } };
+      }
+    );
+
+    return result;
+  }
+
+  SHVec3 KeyQuantisation::DecodeVector(QuantisedVector const& value, SHVec3 const& offset, SHVec3 const& scale) noexcept
+  {
+    return {
+      offset.x + value.x * scale.x,
+      offset.y + value.y * scale.y,
+      offset.z + value.z * scale.z
+    };
+  }
+
+  SHVec4 KeyQuantisation::DecodeRotation(QuantisedRotation const& value) noexcept
+  {
+    uint64_t const bits{
+      static_cast<uint64_t>(value.bits[0]) |
+      static_cast<uint64_t>(value.bits[1]) << 16 |
+      static_cast<uint64_t>(value.bits[2]) << 32
+    };
+
+    auto const largest{ static_cast<size_t>((bits >> 45) & 0x3) };
+
+    std::array<float, 4> components;
+    float sumOfSquares{ 0.f };
+    uint32_t shift{ 0 };
+    for (size_t i{ 0 }; i < components.size(); ++i)
+    {
+      if (i == largest)
+        continue;
+
+      auto const normalised{ static_cast<float>((bits >> shift) & 0x7FFF) / UNORM15_MAX };
+      components[i] = (normalised * 2.f - 1.f) / SQRT_2;
+      sumOfSquares += components[i] * components[i];
+      shift += 15;
+    }
+
+    components[largest] = std::sqrt(std::max(1.f - sumOfSquares, 0.f));
+    return { components[0], components[1], components[2], components[3] };
+  }
+
+  KeyframeTolerance KeyQuantisation::MeasureError(AnimData const& anim, std::vector<QuantisedNodeHeader> const& headers) noexcept
+  {
+    KeyframeTolerance error{ 0.f, 0.f, 0.f };
+    for (size_t i{ 0 }; i < anim.nodes.size(); ++i)
+    {
+      auto const& node{ anim.nodes[i] };
+      auto const& header{ headers[i] };
+
+      error.position = std::max(error.position, VectorError(
+        node.positionKeys, header.positionOffset, header.positionScale,
+        header.constantChannels & ANIM_CHANNEL_POSITION));
+
+      error.scale = std::max(error.scale, VectorError(
+        node.scaleKeys, header.scaleOffset, header.scaleScale,
+        header.constantChannels & ANIM_CHANNEL_SCALE));
+
+      auto const encoded{ EncodeRotations(node.rotationKeys) };
+      for (size_t j{ 0 }; j < encoded.size(); ++j)
+      {
+        auto const value{ header.constantChannels & ANIM_CHANNEL_ROTATION ? header.rotation : DecodeRotation(encoded[j]) };
+        error.rotation = std::max(error.rotation, Angle(value, node.rotationKeys[j].value));
+      }
+    }
+
+    return error;
+  }
+
+  size_t KeyQuantisation::KeyBytes(AnimData const& anim) noexcept
+  {
+    auto const quantised{ !anim.quantisedNodes.empty() };
+
+    size_t bytes{ 0 };
+    for (size_t i{ 0 }; i < anim.nodes.size(); ++i)
+    {
+      auto const& node{ anim.nodes[i] };
+      auto const constant{ quantised ? anim.quantisedNodes[i].constantChannels : AnimChannelFlag{ 0 } };
+      auto const keysOf = [constant](auto const& keys, AnimChannelFlag channel) -> size_t
+      {
+        return constant & channel ? 0 : keys.size();
+      };
+
+      bytes += sizeof(AnimNodeHeader);
+      if (quantised)
+      {
+        bytes += sizeof(QuantisedNodeHeader) +
+          keysOf(node.positionKeys, ANIM_CHANNEL_POSITION) * (sizeof(float) + sizeof(QuantisedVector)) +
+          keysOf(node.rotationKeys, ANIM_CHANNEL_ROTATION) * (sizeof(float) + sizeof(QuantisedRotation)) +
+          keysOf(node.scaleKeys, ANIM_CHANNEL_SCALE) * (sizeof(float) + sizeof(QuantisedVector));
+      }
+      else
+      {
+        bytes += node.positionKeys.size() * sizeof(PositionKey) +
+          node.rotationKeys.size() * sizeof(RotationKey) +
+          node.scaleKeys.size() * sizeof(ScaleKey);
+      }
+    }
+
+    return bytes;
+  }
+}
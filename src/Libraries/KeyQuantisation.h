@@ -0,0 +1,44 @@
+/******************************************************************************
+ * \file    KeyQuantisation.h
+ * \author  Loh Xiao Qi
+ * \brief   Encoders for the KEY_ENCODING_QUANTISED animation format in
+ *					AnimationAsset.h
+ * 
+ * \copyright	Copyright (c) 2022 Digipen Institute of Technology. Reproduction
+ *						or disclosure of this file or its contents without the prior
+ *						written consent of Digipen Institute of Technology is prohibited
+ ******************************************************************************/
+#pragma once
+
+#include <vector>
+
+#include "CompileOptions.h"
+#include "Types/AnimationAsset.h"
+
+namespace SH_COMP
+{
+	struct KeyQuantisation
+	{
+		/*************************************************************************
+		 * Ranges of the node's position and scale keys, and which channels can
+		 * collapse to a single value within budget. Empty channels stay
+		 * unanimated rather than constant.
+		 *************************************************************************/
+		static QuantisedNodeHeader ComputeNodeHeader(AnimNode const& node, KeyframeTolerance const& budget) noexcept;
+
+		static std::vector<QuantisedVector> EncodePositions(std::vector<PositionKey> const& keys, QuantisedNodeHeader const& header) noexcept;
+		static std::vector<QuantisedVector> EncodeScales(std::vector<ScaleKey> const& keys, QuantisedNodeHeader const& header) noexcept;
+		static std::vector<QuantisedRotation> EncodeRotations(std::vector<RotationKey> const& keys) noexcept;
+
+		static SHVec3 DecodeVector(QuantisedVector const& value, SHVec3 const& offset, SHVec3 const& scale) noexcept;
+		static SHVec4 DecodeRotation(QuantisedRotation const& value) noexcept;
+
+		// Largest error of each channel over the clip when written with the
+		// given node headers, in the units of KeyframeTolerance
+		static KeyframeTolerance MeasureError(AnimData const& anim, std::vector<QuantisedNodeHeader> const& headers) noexcept;
+
+		// Bytes of key data the clip is written with, leaving out alignment
+		// and counting every channel's times as if no timeline were shared
+		static size_t KeyBytes(AnimData const& anim) noexcept;
+	};
+}
@@ -0,0 +1,143 @@
+/******************************************************************************
+ * \file    MappedFile.cpp
+ * \author  Loh Xiao Qi
+ * \brief   Read only memory mapping of a file on disk
+ * 
+ * \copyright	Copyright (c) 2022 Digipen Institute of Technology. Reproduction
+ *						or disclosure of this file or its contents without the prior
+ *						written consent of Digipen Institute of Technology is prohibited
+ ******************************************************************************/
+#include "MappedFile.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace SH_COMP
+{
+#ifdef _WIN32
+  MappedFile::MappedFile(AssetPath const& path) noexcept
+  {
+    auto const file{ CreateFileW(
+      path.c_str(),
+      GENERIC_READ,
+      FILE_SHARE_READ,
+      nullptr,
+      OPEN_EXISTING,
+      FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+      nullptr
+    ) };
+
+    if (file == INVALID_HANDLE_VALUE)
+      return;
+
+    fileHandle = file;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+      Close();
+      return;
+    }
+
+    mappingHandle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle == nullptr)
+    {
+      Close();
+      return;
+    }
+
+    auto const view{ MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0) };
+    if (view == nullptr)
+    {
+      Close();
+      return;
+    }
+
+    data = static_cast<unsigned char const*>(view);
+    size = static_cast<size_t>(fileSize.QuadPart);
+  }
+
+  void MappedFile::Close() noexcept
+  {
+    if (data)
+      UnmapViewOfFile(data);
+    if (mappingHandle)
+      CloseHandle(mappingHandle);
+    if (fileHandle)
+      CloseHandle(fileHandle);
+
+    data = nullptr;
+    size = 0;
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+  }
+#else
+  MappedFile::MappedFile(AssetPath const& path) noexcept
+  {
+    auto const file{ open(path.c_str(), O_RDONLY) };
+    if (file < 0)
+      return;
+
+    struct stat fileStat;
+    if (fstat(file, &fileStat) != 0 || fileStat.st_size == 0)
+    {
+      close(file);
+      return;
+    }
+
+    auto const view{ mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, file, 0) };
+    close(file);
+
+    if (view == MAP_FAILED)
+      return;
+
+    data = static_cast<unsigned char const*>(view);
+    size = static_cast<size_t>(fileStat.st_size);
+  }
+
+  void MappedFile::Close() noexcept
+  {
+    if (data)
+      munmap(const_cast<unsigned char*>(data), size);
+
+    data = nullptr;
+    size = 0;
+  }
+#endif
+
+  MappedFile::~MappedFile() noexcept
+  {
+    Close();
+  }
+
+  MappedFile::MappedFile(MappedFile&& rhs) noexcept
+  {
+    *this = std::move(rhs);
+  }
+
+  MappedFile& MappedFile::operator=(MappedFile&& rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      Close();
+      std::swap(data, rhs.data);
+      std::swap(size, rhs.size);
+#ifdef _WIN32
+      std::swap(fileHandle, rhs.fileHandle);
+      std::swap(mappingHandle, rhs.mappingHandle);
+#endif
+    }
+
+    return *this;
+  }
+}
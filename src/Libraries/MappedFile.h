@@ -0,0 +1,47 @@
+/******************************************************************************
+ * \file    MappedFile.h
+ * \author  Loh Xiao Qi
+ * \brief   Read only memory mapping of a file on disk. Lets source buffers be
+ *					read in place instead of being copied into memory first.
+ * 
+ * \copyright	Copyright (c) 2022 Digipen Institute of Technology. Reproduction
+ *						or disclosure of this file or its contents without the prior
+ *						written consent of Digipen Institute of Technology is prohibited
+ ******************************************************************************/
+#pragma once
+
+#include <span>
+
+#include "AssetMacros.h"
+
+namespace SH_COMP
+{
+	using MappedBytes = std::span<unsigned char const>;
+
+	class MappedFile
+	{
+		unsigned char const* data{ nullptr };
+		size_t size{ 0 };
+
+#ifdef _WIN32
+		void* fileHandle{ nullptr };
+		void* mappingHandle{ nullptr };
+#endif
+
+		void Close() noexcept;
+
+	public:
+		MappedFile() noexcept = default;
+		explicit MappedFile(AssetPath const& path) noexcept;
+		~MappedFile() noexcept;
+
+		MappedFile(MappedFile&& rhs) noexcept;
+		MappedFile& operator=(MappedFile&& rhs) noexcept;
+
+		MappedFile(MappedFile const&) = delete;
+		MappedFile& operator=(MappedFile const&) = delete;
+
+		bool IsOpen() const noexcept { return data != nullptr; }
+		MappedBytes Bytes() const noexcept { return { data, size }; }
+	};
+}
@@ -13,16 +13,22 @@
 #pragma once
 
 #include <vector>
+#include <iostream>
 
 #include "Types/AnimationAsset.h"
 #include "Types/ModelAsset.h"
 #include "AssetMacros.h"
+#include "CompileOptions.h"
+#include "MappedFile.h"
+#include "AccessorConversion.h"
+#include "AnimationSampler.h"
 
 //Forward Declare
 namespace tinygltf
 {
 	struct Accessor;
   struct BufferView;
+  struct Primitive;
 	class Model;
 }
 
@@ -33,31 +39,67 @@ namespace SH_COMP
 
   using ModelRef = ModelAsset&;
   using ModelData = tinygltf::Model;
+  using PrimitiveData = tinygltf::Primitive;
   using AccessorReference = std::vector<tinygltf::Accessor> const*;
   using BufferViewReference = std::vector<tinygltf::BufferView> const*;
-  using BufferData = unsigned char const*;
 
+  /***************************************************************************
+   * One MeshCompiler instance is created per compile job. All gltf lookup
+   * state lives on the instance so that separate files can be compiled
+   * concurrently from different threads.
+   ***************************************************************************/
   class MeshCompiler
   {
-    static AccessorReference accessors;
-    static BufferViewReference bufferViews;
-    static BufferData buffer;
+    AccessorReference accessors{ nullptr };
+    BufferViewReference bufferViews{ nullptr };
 
-  	static inline bool LoadFromFile(AssetPath path, ModelRef asset) noexcept;
+    // Payload of one gltf buffer. External files are only mapped the first
+    // time an accessor reads from them, until then path is set.
+    struct SourceBuffer
+    {
+      AssetPath path;
+      size_t byteLength{ 0 };
+      MappedBytes bytes;
+    };
 
-    static inline bool ProcessMesh(ModelData const& data, ModelRef asset) noexcept;
-    static inline void ProcessAnimationChannels(ModelData const& data, ModelRef asset) noexcept;
-    static inline void ProcessRigNodes(ModelData const& data, ModelRef asset) noexcept;
+    std::vector<SourceBuffer> sourceBuffers;
+    std::vector<MappedFile> mappedFiles;
 
-    static inline void BuildHeaders(ModelRef asset) noexcept;
+    CompileOptions const& options;
+    std::ostream& log;
+
+    MeshCompiler(CompileOptions const& compileOptions, std::ostream& logStream) noexcept;
+
+  	inline bool LoadFromFile(AssetPath path, ModelRef asset) noexcept;
+    inline bool LoadCopied(AssetPath path, ModelData& model, std::string& warn, std::string& error) noexcept;
+    inline bool LoadMapped(AssetPath path, ModelData& model, std::string& warn, std::string& error) noexcept;
+
+    static inline bool ReadGlbChunks(MappedBytes file, std::string_view& json, MappedBytes& bin) noexcept;
+
+    inline bool ProcessMesh(ModelData const& data, ModelRef asset) noexcept;
+    inline void ProcessPrimitive(PrimitiveData const& primitive, MeshData& meshIn, bool hasAnims);
+    inline void ProcessAnimationChannels(ModelData const& data, ModelRef asset);
+    inline void ProcessRigNodes(ModelData const& data, ModelRef asset);
+
+    inline void OptimiseMeshes(ModelRef asset) noexcept;
+    inline void OptimiseAnimations(ModelRef asset) noexcept;
+    inline void BuildHeaders(ModelRef asset) noexcept;
+
+    inline MappedBytes GetBuffer(int bufferID);
+    inline AccessorView GetAccessorView(int accessorID);
 
     template<typename T>
-    static void FetchData(int accessorID, std::vector<T>& dst);
+    void FetchData(int accessorID, std::vector<T>& dst);
+
+    // Samples per second clip is baked to, 0 if it keeps its source keys
+    inline float SampleRate(std::string const& clip) const noexcept;
 
     template<typename T>
-    static void FetchChannelKeyFrame(int inputAcc, int outputAcc, std::vector<T>& dst);
+    static void FetchChannelKeyFrame(AnimationSampler::Curve const& curve, float sampleRate, uint32_t sampleCount, std::vector<T>& dst);
   public:
-    static inline void LoadAndCompile(AssetPath path) noexcept;
+    // Compiles a single file. Messages are written to log so that parallel
+    // jobs can be reported in a deterministic order by the caller.
+    static inline bool LoadAndCompile(AssetPath path, CompileOptions const& options = {}, std::ostream& log = std::cout) noexcept;
 	};
 }
 
@@ -14,38 +14,54 @@
 
 #include "MeshCompiler.h"
 #include "MeshWriter.h"
+#include "BuildCache.h"
+#include "AccessorConversion.h"
+#include "MeshOptimiser.h"
+#include "VertexQuantisation.h"
+#include "MeshletBuilder.h"
+#include "MeshSimplifier.h"
+#include "BoundingVolumes.h"
+#include "MeshReader.h"
+#include "AnimationOptimiser.h"
+#include "KeyQuantisation.h"
 
 #include <fstream>
 #include <iostream>
 #include <algorithm>
 
 #include "Includes/tiny_gltf.h"
+#include "Includes/json.hpp"
 #include <map>
 #include <stack>
+#include <numeric>
+#include <limits>
+#include <thread>
+#include <chrono>
 
 namespace SH_COMP
 {
-  AccessorReference MeshCompiler::accessors{ nullptr };
-  BufferViewReference MeshCompiler::bufferViews{ nullptr };
-  BufferData MeshCompiler::buffer{ nullptr };
+  inline MeshCompiler::MeshCompiler(CompileOptions const& compileOptions, std::ostream& logStream) noexcept
+    :options{ compileOptions }, log{ logStream }
+  {}
 
   inline bool MeshCompiler::LoadFromFile(AssetPath path, ModelRef asset) noexcept
   {
     ModelData model;
-    tinygltf::TinyGLTF loader;
     std::string warn, error;
 
-    bool result = loader.LoadASCIIFromFile(&model, &error, &warn, path.string());
+    bool result = options.mapSourceBuffers ?
+      LoadMapped(path, model, warn, error) :
+      LoadCopied(path, model, warn, error);
 
     if (!warn.empty())
-      std::cout << "[TinyGLTF Warning] " << warn;
+      log << "[TinyGLTF Warning] " << warn;
 
     if (!error.empty())
-      std::cout << "[TinyGLTF Error] " << error;
+      log << "[TinyGLTF Error] " << error;
 
     if (!result)
     { 
-	    std::cout << "[TinyGLTF] Failed to parse\n";
+	    log << "[TinyGLTF] Failed to parse\n";
       return false;
     }
 
@@ -54,8 +70,16 @@ namespace SH_COMP
 			auto const hasAnims {!model.animations.empty()};
       if (hasAnims)
       {
-		    ProcessRigNodes(model, asset);
-		    ProcessAnimationChannels(model, asset);
+        try
+        {
+		      ProcessRigNodes(model, asset);
+		      ProcessAnimationChannels(model, asset);
+        }
+        catch (std::out_of_range const& e)
+        {
+	        log << "[Model Compiler] Failed to load animation data from gltf: " << e.what() << "\n";
+          return false;
+        }
       }
       return true;
     }
@@ -63,141 +87,523 @@ namespace SH_COMP
     return false;
   }
 
+  inline bool MeshCompiler::LoadCopied(AssetPath path, ModelData& model, std::string& warn, std::string& error) noexcept
+  {
+    tinygltf::TinyGLTF loader;
+
+    // Binary gltf keeps its buffer in the BIN chunk, no base64 or .bin lookup
+    bool result = path.extension().string() == GLB_EXTENSION ?
+      loader.LoadBinaryFromFile(&model, &error, &warn, path.string()) :
+      loader.LoadASCIIFromFile(&model, &error, &warn, path.string());
+
+    for (auto const& gltfBuffer : model.buffers)
+    {
+      sourceBuffers.push_back({ {}, gltfBuffer.data.size(), gltfBuffer.data });
+    }
+
+    return result;
+  }
+
+  inline bool MeshCompiler::LoadMapped(AssetPath path, ModelData& model, std::string& warn, std::string& error) noexcept
+  {
+    auto const fileBytes{ mappedFiles.emplace_back(path).Bytes() };
+    if (fileBytes.empty())
+    {
+      error += "Failed to map file: " + path.string() + "\n";
+      return false;
+    }
+
+    std::string_view jsonText{ reinterpret_cast<char const*>(fileBytes.data()), fileBytes.size() };
+    MappedBytes binChunk;
+    if (path.extension().string() == GLB_EXTENSION && !ReadGlbChunks(fileBytes, jsonText, binChunk))
+    {
+      error += "Invalid binary gltf layout: " + path.string() + "\n";
+      return false;
+    }
+
+    auto json = nlohmann::json::parse(jsonText, nullptr, false);
+    if (json.is_discarded() || !json.is_object())
+    {
+      error += "Failed to parse gltf json: " + path.string() + "\n";
+      return false;
+    }
+
+    // Point every external and BIN chunk buffer at its source file, then swap
+    // the json entry for a 1 byte placeholder so tinygltf does not load a
+    // copy. Data uri buffers are left for tinygltf to decode.
+    std::vector<SourceBuffer> mappedBuffers;
+    if (auto const buffers{ json.find("buffers") }; buffers != json.end() && buffers->is_array())
+    {
+      for (size_t i{ 0 }; i < buffers->size(); ++i)
+      {
+        auto& gltfBuffer{ (*buffers)[i] };
+        auto& source{ mappedBuffers.emplace_back() };
+        auto const uri{ gltfBuffer.value("uri", std::string{}) };
+        source.byteLength = gltfBuffer.value("byteLength", size_t{ 0 });
+
+        if (uri.starts_with("data:"))
+          continue;
+
+        if (uri.empty())
+        {
+          if (i != 0 || binChunk.size() < source.byteLength)
+          {
+            error += "Missing BIN chunk for buffer " + std::to_string(i) + " of " + path.string() + "\n";
+            return false;
+          }
+
+          source.bytes = binChunk.first(source.byteLength);
+        }
+        else
+        {
+          std::string decodedUri;
+          tinygltf::URIDecode(uri, &decodedUri, nullptr);
+          source.path = path.parent_path() / decodedUri;
+        }
+
+        gltfBuffer = {
+          {"byteLength", 1},
+          {"uri", "data:application/octet-stream;base64,AA=="}
+        };
+      }
+    }
+
+    auto const text{ json.dump() };
+    tinygltf::TinyGLTF loader;
+    if (!loader.LoadASCIIFromString(
+      &model, &error, &warn,
+      text.data(), static_cast<unsigned int>(text.size()),
+      path.parent_path().string()
+    ))
+    {
+      return false;
+    }
+
+    sourceBuffers = std::move(mappedBuffers);
+    sourceBuffers.resize(model.buffers.size());
+    for (size_t i{ 0 }; i < model.buffers.size(); ++i)
+    {
+      auto& source{ sourceBuffers[i] };
+      if (source.path.empty() && source.bytes.empty())
+        source.bytes = model.buffers[i].data;
+    }
+
+    return true;
+  }
+
+  inline bool MeshCompiler::ReadGlbChunks(MappedBytes file, std::string_view& json, MappedBytes& bin) noexcept
+  {
+    auto const readWord = [file](size_t offset)->uint32_t
+    {
+      uint32_t word{ 0 };
+      std::memcpy(&word, file.data() + offset, sizeof(uint32_t));
+      return word;
+    };
+
+    if (file.size() < GLB_HEADER_SIZE + GLB_CHUNK_HEADER_SIZE || readWord(0) != GLB_MAGIC)
+      return false;
+
+    size_t offset{ GLB_HEADER_SIZE };
+    size_t const jsonLength{ readWord(offset) };
+    if (readWord(offset + sizeof(uint32_t)) != GLB_CHUNK_JSON ||
+      offset + GLB_CHUNK_HEADER_SIZE + jsonLength > file.size())
+      return false;
+
+    offset += GLB_CHUNK_HEADER_SIZE;
+    json = { reinterpret_cast<char const*>(file.data() + offset), jsonLength };
+    offset += jsonLength;
+
+    // BIN chunk is optional
+    if (offset + GLB_CHUNK_HEADER_SIZE <= file.size() && readWord(offset + sizeof(uint32_t)) == GLB_CHUNK_BIN)
+    {
+      size_t const binLength{ readWord(offset) };
+      offset += GLB_CHUNK_HEADER_SIZE;
+      if (offset + binLength > file.size())
+        return false;
+
+      bin = file.subspan(offset, binLength);
+    }
+
+    return true;
+  }
+
   inline bool MeshCompiler::ProcessMesh(ModelData const& data, ModelRef asset) noexcept
   {
     accessors = &data.accessors;
     bufferViews = &data.bufferViews;
-    buffer = data.buffers[0].data.data();
     auto const hasAnims {!data.animations.empty()};
 
     for (auto const& mesh : data.meshes)
     {
-      auto const& primitive { mesh.primitives[0] };
       auto& meshIn {asset.meshes.emplace_back()};
       meshIn.name = mesh.name;
 
-      try
-      {
-        FetchData(primitive.attributes.at(ATT_POSITION.data()), meshIn.vertexPosition);
-        FetchData(primitive.attributes.at(ATT_NORMAL.data()), meshIn.vertexNormal);
-        FetchData(primitive.attributes.at(ATT_TEXCOORD.data()), meshIn.texCoords);
-        FetchData(primitive.indices, meshIn.indices);
-
-        std::vector<SHVec4> intermediate;
-        FetchData(primitive.attributes.at(ATT_TANGENT.data()), intermediate);
-        meshIn.vertexTangent.resize(intermediate.size());
-        std::ranges::transform(
-          intermediate,
-					meshIn.vertexTangent.begin(),
-          [](auto const& inTan)
-		       {
-		         return SHVec3{ inTan.x, inTan.y, inTan.z };
-		       }
-        );
-      }
-      catch (std::out_of_range e)
+      for (auto const& primitive : mesh.primitives)
       {
-	      std::cout << "[Model Compiler] Failed to load critical data from gltf\n";
-        return false;
-      }
+        if (primitive.mode != static_cast<int>(PRIMITIVE_MODE::TRIANGLE))
+        {
+	        log << "[Model Compiler] Skipping non triangle primitive in mesh: " << mesh.name << std::endl;
+          continue;
+        }
 
-      if (hasAnims)
-      {
-	      try
-	      {
-	        FetchData(primitive.attributes.at(ATT_WEIGHTS.data()), meshIn.weights);
-	        FetchData(primitive.attributes.at(ATT_JOINT.data()), meshIn.joints);
-	      }
-	      catch(std::out_of_range e)
-	      {
-	        std::cout << "[Model Compiler] No weights and joints found for mesh: " << mesh.name << std::endl;
-	      }
+        try
+        {
+          ProcessPrimitive(primitive, meshIn, hasAnims);
+        }
+        catch (std::out_of_range const& e)
+        {
+	        log << "[Model Compiler] Failed to load critical data from gltf: " << e.what() << "\n";
+          return false;
+        }
       }
     }
 
     return true;
   }
 
-  template <typename T>
-  void MeshCompiler::FetchData(int accessorID, std::vector<T>& dst)
+  inline void MeshCompiler::ProcessPrimitive(PrimitiveData const& primitive, MeshData& meshIn, bool hasAnims)
   {
-    auto const& accessor = (*accessors)[accessorID];
-    auto const& view = (*bufferViews)[accessor.bufferView];
-    auto const typeIdentifier{ static_cast<ACCESSOR_COMPONENT_TYPE>(accessor.componentType) };
-    auto const sizeIdentifier{ SizeOfType(typeIdentifier) };
-    auto const componentCount{ CountOfType(static_cast<ACCESSOR_DATA_TYPE>(accessor.type))};
-    auto const totalStrideBytes{ sizeIdentifier * componentCount };
-    dst.resize(accessor.count);
-    if (sizeof(T) == totalStrideBytes)
-    {
-      std::memcpy(
-        dst.data(),
-        buffer + view.byteOffset,
-        view.byteLength
-      );
+    MeshData part;
+    FetchData(primitive.attributes.at(ATT_POSITION.data()), part.vertexPosition);
+    FetchData(primitive.attributes.at(ATT_NORMAL.data()), part.vertexNormal);
+    FetchData(primitive.attributes.at(ATT_TEXCOORD.data()), part.texCoords);
+
+    if (primitive.indices >= 0)
+    {
+      FetchData(primitive.indices, part.indices);
+    }
+    else
+    {
+      part.indices.resize(part.vertexPosition.size());
+      std::iota(part.indices.begin(), part.indices.end(), IndexType{ 0 });
+    }
+
+    // Welding, the vertex cache pass, meshlets and LODs all index their per
+    // vertex arrays with these unchecked
+    auto const vertexCount{ part.vertexPosition.size() };
+    if (std::ranges::any_of(part.indices, [vertexCount](IndexType index) { return index >= vertexCount; }))
+    {
+	    log << "[Model Compiler] Skipping primitive with indices past its " << vertexCount << " vertices in mesh: " << meshIn.name << std::endl;
       return;
     }
 
-    std::vector<std::byte> tempData(view.byteLength);
-    std::memcpy(
-      tempData.data(),
-      buffer + view.byteOffset,
-      view.byteLength
+    std::vector<SHVec4> intermediate;
+    FetchData(primitive.attributes.at(ATT_TANGENT.data()), intermediate);
+    part.vertexTangent.resize(intermediate.size());
+    std::ranges::transform(
+      intermediate,
+			part.vertexTangent.begin(),
+      [](auto const& inTan)
+		   {
+		     return SHVec3{ inTan.x, inTan.y, inTan.z };
+		   }
     );
 
-    auto srcPtr{ tempData.data() };
-    T* dstPtr{ dst.data() };
-    size_t index{ 0 };
-    for (auto i{0}; i < accessor.count; ++i, ++index)
+    if (hasAnims)
     {
-      auto srcCompPtr{ srcPtr };
-      auto dstCompPtr{ reinterpret_cast<IndexType*>(dstPtr)};
-      for (auto j{0}; j < componentCount; ++j)
+      // Only missing attributes leave the mesh unskinned, accessors that
+      // fail to read fail the primitive like any other attribute
+      auto const weights{ primitive.attributes.find(ATT_WEIGHTS.data()) };
+      auto const joints{ primitive.attributes.find(ATT_JOINT.data()) };
+      if (weights != primitive.attributes.end() && joints != primitive.attributes.end())
       {
-        std::memcpy(
-          dstCompPtr,
-          srcCompPtr,
-          sizeIdentifier
-        );
-
-        srcCompPtr += sizeIdentifier;
-        ++dstCompPtr;
+        FetchData(weights->second, part.weights);
+        FetchData(joints->second, part.joints);
       }
+      else
+      {
+	      log << "[Model Compiler] No weights and joints found for mesh: " << meshIn.name << std::endl;
+      }
+    }
+
+    // Float positions with a declared min/max spare a scan for the mesh bounds
+    auto const& positionAccessor{ accessors->at(primitive.attributes.at(ATT_POSITION.data())) };
+    bool const declaresBounds{
+      static_cast<ACCESSOR_COMPONENT_TYPE>(positionAccessor.componentType) == ACCESSOR_COMPONENT_TYPE::FLOAT &&
+      positionAccessor.minValues.size() >= 3 && positionAccessor.maxValues.size() >= 3
+    };
+
+    if (declaresBounds && (meshIn.subMeshes.empty() || meshIn.hasSourceBounds))
+    {
+      BoundingBox const bounds{
+        SHVec3{
+          static_cast<float>(positionAccessor.minValues[0]),
+          static_cast<float>(positionAccessor.minValues[1]),
+          static_cast<float>(positionAccessor.minValues[2])
+        },
+        SHVec3{
+          static_cast<float>(positionAccessor.maxValues[0]),
+          static_cast<float>(positionAccessor.maxValues[1]),
+          static_cast<float>(positionAccessor.maxValues[2])
+        }
+      };
+
+      meshIn.sourceBounds = meshIn.subMeshes.empty() ? bounds : BoundingVolumes::Merge(meshIn.sourceBounds, bounds);
+      meshIn.hasSourceBounds = true;
+    }
+    else
+    {
+      meshIn.hasSourceBounds = false;
+    }
+
+    // Every primitive is appended to the same vertex and index streams, with
+    // its indices rebased so the whole mesh draws from one buffer pair
+    auto const baseVertex{ static_cast<IndexType>(meshIn.vertexPosition.size()) };
+    auto const indexOffset{ static_cast<uint32_t>(meshIn.indices.size()) };
+
+    meshIn.subMeshes.push_back({
+      indexOffset,
+      static_cast<uint32_t>(part.indices.size()),
+      primitive.material,
+      0, 0
+    });
+
+    for (auto& index : part.indices)
+    {
+      index += baseVertex;
+    }
+
+    // Skinning streams must stay parallel to the positions even when only
+    // some primitives carry them. Unskinned vertices follow joint 0.
+    bool const skinned{ !part.weights.empty() || !meshIn.weights.empty() };
+    if (skinned)
+    {
+      meshIn.weights.resize(baseVertex, SHVec4{ 1.f, 0.f, 0.f, 0.f });
+      meshIn.joints.resize(baseVertex, SHVec4i{ 0, 0, 0, 0 });
+      part.weights.resize(part.vertexPosition.size(), SHVec4{ 1.f, 0.f, 0.f, 0.f });
+      part.joints.resize(part.vertexPosition.size(), SHVec4i{ 0, 0, 0, 0 });
+    }
 
-      srcPtr += totalStrideBytes;
+    auto const append = [](auto& dst, auto& src)
+    {
+      if (dst.empty())
+        dst = std::move(src);
+      else
+        dst.insert(dst.end(), src.begin(), src.end());
+    };
+
+    append(meshIn.vertexPosition, part.vertexPosition);
+    append(meshIn.vertexTangent, part.vertexTangent);
+    append(meshIn.vertexNormal, part.vertexNormal);
+    append(meshIn.texCoords, part.texCoords);
+    append(meshIn.indices, part.indices);
+    append(meshIn.weights, part.weights);
+    append(meshIn.joints, part.joints);
+  }
 
-      ++dstPtr;
+  inline MappedBytes MeshCompiler::GetBuffer(int bufferID)
+  {
+    auto& source{ sourceBuffers.at(bufferID) };
+    if (!source.path.empty())
+    {
+      auto const bytes{ mappedFiles.emplace_back(source.path).Bytes() };
+      if (bytes.size() < source.byteLength || bytes.empty())
+        throw std::out_of_range{ "failed to map buffer file " + source.path.string() };
+
+      source.bytes = bytes.first(source.byteLength);
+      source.path.clear();
     }
+
+    return source.bytes;
+  }
+
+  inline AccessorView MeshCompiler::GetAccessorView(int accessorID)
+  {
+    auto const& accessor{ accessors->at(accessorID) };
+
+    AccessorView result{
+      .count = accessor.count,
+      .componentCount = CountOfType(static_cast<ACCESSOR_DATA_TYPE>(accessor.type)),
+      .componentType = static_cast<ACCESSOR_COMPONENT_TYPE>(accessor.componentType),
+      .normalized = accessor.normalized
+    };
+
+    // Accessors without a bufferView read as zeros
+    if (accessor.bufferView < 0)
+      return result;
+
+    auto const& view{ bufferViews->at(accessor.bufferView) };
+    auto const elementSize{ result.ElementSize() };
+    result.stride = view.byteStride != 0 ? view.byteStride : elementSize;
+
+    auto const buffer{ GetBuffer(view.buffer) };
+    auto const accessorBytes{ accessor.count == 0 ? 0 : result.stride * (accessor.count - 1) + elementSize };
+    if (elementSize == 0 ||
+      accessor.byteOffset + accessorBytes > view.byteLength ||
+      view.byteOffset + view.byteLength > buffer.size())
+    {
+      throw std::out_of_range{ "accessor " + std::to_string(accessorID) + " reads outside of its buffer" };
+    }
+
+    result.data = buffer.data() + view.byteOffset + accessor.byteOffset;
+    return result;
+  }
+
+  template <typename T>
+  void MeshCompiler::FetchData(int accessorID, std::vector<T>& dst)
+  {
+    GetAccessorView(accessorID).CopyTo(dst);
   }
 
   template <typename T>
-  void MeshCompiler::FetchChannelKeyFrame(int inputAcc, int outputAcc, std::vector<T>& dst)
+  void MeshCompiler::FetchChannelKeyFrame(AnimationSampler::Curve const& curve, float sampleRate, uint32_t sampleCount, std::vector<T>& dst)
   {
     // ONLY ALLOW THIS FUNCTION TO BE USED ON KEY DATA STRUCT
     static_assert(std::derived_from<T, KeyBase> == true);
 
-    std::vector<float> inputVec;
-    std::vector<SHVec4> outputVec;
-    FetchData(inputAcc, inputVec);
-    FetchData(outputAcc, outputVec);
+    if (sampleRate <= 0.f)
+    {
+      auto const values{ AnimationSampler::KeyValues(curve) };
+      dst.resize(values.size());
+      for (size_t i{ 0 }; i < values.size(); ++i)
+        dst[i] = T{ { curve.times[i] }, values[i] };
 
-    dst.resize(inputVec.size());
+      return;
+    }
 
-    std::ranges::transform(
-      inputVec,
-      outputVec,
-      dst.begin(),
-      [](float const& time, SHVec4 const& value)->T
+    // One key per tick, see KEY_ENCODING_UNIFORM
+    auto const samples{ AnimationSampler::Resample(curve, std::same_as<T, RotationKey>, sampleRate, sampleCount) };
+    dst.resize(samples.size());
+    for (size_t i{ 0 }; i < samples.size(); ++i)
+      dst[i] = T{ { static_cast<float>(i) }, samples[i] };
+  }
+
+  inline float MeshCompiler::SampleRate(std::string const& clip) const noexcept
+  {
+    auto const clipRate{ options.clipSampleRates.find(clip) };
+    float const rate{ clipRate != options.clipSampleRates.end() ? clipRate->second : options.sampleRate };
+    return std::max(rate, 0.f);
+  }
+
+  inline void MeshCompiler::OptimiseMeshes(ModelRef asset) noexcept
+  {
+    for (auto& mesh : asset.meshes)
+    {
+      if (options.weldVertices)
       {
-        return { time, value };
+        auto const before{ mesh.vertexPosition.size() };
+        auto const after{ MeshOptimiser::WeldVertices(mesh, options.weldEpsilon) };
+
+        log << "[Model Compiler] Welded " << mesh.name
+          << ": " << before << " -> " << after << " vertices\n";
       }
-    );
+
+      if (!options.lodRatios.empty())
+      {
+        MeshSimplifier::BuildLods(mesh, options.lodRatios, options.lodMaxError);
+
+        log << "[Model Compiler] LODs " << mesh.name << ": " << mesh.indices.size() / 3;
+        for (auto const& lod : mesh.lods)
+          log << " -> " << lod.indexCount / 3 << " (error " << lod.error << ")";
+        log << " triangles\n";
+      }
+
+      if (options.optimiseVertexCache)
+      {
+        auto const before{ MeshOptimiser::AnalyseVertexCache(mesh) };
+        MeshOptimiser::OptimiseVertexCache(mesh);
+        auto const after{ MeshOptimiser::AnalyseVertexCache(mesh) };
+
+        log << "[Model Compiler] Vertex cache " << mesh.name
+          << ": ACMR " << before.acmr << " -> " << after.acmr
+          << ", ATVR " << before.atvr << " -> " << after.atvr << "\n";
+      }
+
+      // Runs after triangle reordering so first use order matches draw order
+      if (options.optimiseVertexFetch)
+        MeshOptimiser::OptimiseVertexFetch(mesh);
+    }
+
+    // Last, as it indexes into the final vertex order
+    if (options.buildMeshlets)
+    {
+      MeshletBuilder::Build(asset.meshes, options.meshletMaxVertices, options.meshletMaxTriangles,
+        options.threadsPerJob > 0 ? options.threadsPerJob : std::thread::hardware_concurrency());
+
+      for (auto const& mesh : asset.meshes)
+        log << "[Model Compiler] Meshlets " << mesh.name << ": " << mesh.meshlets.size() << "\n";
+    }
+  }
+
+  inline void MeshCompiler::OptimiseAnimations(ModelRef asset) noexcept
+  {
+    for (auto& anim : asset.anims)
+    {
+      // Dropping keys would break the one key per tick layout
+      if (options.reduceKeyframes && SampleRate(anim.name) > 0.f)
+      {
+        log << "[Model Compiler] Skipped key reduction of resampled " << anim.name << "\n";
+      }
+      else if (options.reduceKeyframes)
+      {
+        auto const clipTolerance{ options.clipKeyTolerances.find(anim.name) };
+        auto const& tolerance{ clipTolerance != options.clipKeyTolerances.end() ?
+          clipTolerance->second : options.keyTolerance };
+
+        auto const before{ AnimationOptimiser::CountKeys(anim) };
+        auto const after{ AnimationOptimiser::ReduceKeys(anim, tolerance) };
+
+        log << "[Model Compiler] Keys " << anim.name << ": " << before << " -> " << after;
+        if (after > 0)
+          log << " (" << static_cast<float>(before) / after << ":1)";
+        log << "\n";
+      }
+
+      // Last, so the error is measured on the keys that are written
+      if (options.quantiseKeys && (options.quantisedClips.empty() || options.quantisedClips.contains(anim.name)))
+      {
+        auto const& budget{ options.keyQuantisationBudget };
+
+        std::vector<QuantisedNodeHeader> headers;
+        headers.reserve(anim.nodes.size());
+        for (auto const& node : anim.nodes)
+          headers.push_back(KeyQuantisation::ComputeNodeHeader(node, budget));
+
+        auto const error{ KeyQuantisation::MeasureError(anim, headers) };
+        bool const withinBudget{
+          error.position <= budget.position &&
+          error.rotation <= budget.rotation &&
+          error.scale <= budget.scale
+        };
+
+        auto const before{ KeyQuantisation::KeyBytes(anim) };
+        anim.quantisedNodes = std::move(headers);
+        auto const after{ KeyQuantisation::KeyBytes(anim) };
+
+        // Node headers can outweigh the keys they save on very short clips
+        if (!withinBudget || after >= before)
+          anim.quantisedNodes.clear();
+
+        log << "[Model Compiler] "
+          << (!withinBudget ? "Kept full precision keys, over budget, " : after >= before ? "Kept full precision keys, not smaller, " : "Quantised keys ")
+          << anim.name << ": error " << error.position << ", " << error.rotation << ", " << error.scale
+          << ", " << before << " -> " << after << " bytes";
+        log << "\n";
+      }
+
+      AnimationOptimiser::ShareTimelines(anim);
+
+      size_t channelTimes{ 0 };
+      for (auto const& node : anim.nodeHeaders)
+      {
+        for (auto const& channel : { node.position, node.rotation, node.scale })
+        {
+          if (channel.timeline != NO_TIMELINE)
+            channelTimes += anim.timelines[channel.timeline].count;
+        }
+      }
+
+      log << "[Model Compiler] Timelines " << anim.name << ": " << channelTimes << " -> " << anim.times.size()
+        << " key times in " << anim.timelines.size() << " timelines\n";
+    }
   }
 
   inline void MeshCompiler::BuildHeaders(ModelRef asset) noexcept
   {
     // Mesh Headers
     asset.meshHeaders.resize(asset.meshes.size());
+    asset.header.magic = MODEL_FILE_MAGIC;
+    asset.header.version = MODEL_COMPILER_VERSION;
     asset.header.meshCount = asset.meshes.size();
     for (auto i{ 0 }; i < asset.header.meshCount; ++i)
     {
@@ -207,7 +613,71 @@ namespace SH_COMP
       head.charCount = mesh.name.size();
       head.indexCount = mesh.indices.size();
       head.vertexCount = mesh.vertexPosition.size();
+      head.subMeshCount = mesh.subMeshes.size();
+      head.meshletCount = mesh.meshlets.size();
+      head.meshletVertexCount = mesh.meshletVertices.size();
+      head.meshletTriangleSize = mesh.meshletTriangles.size();
+      head.lodCount = mesh.lods.size();
+      head.lodIndexCount = mesh.lodIndices.size();
       head.hasWeights = mesh.weights.empty() ? false : true;
+
+      // 16 bit whenever every index fits, 0xFFFF is kept free for primitive restart
+      head.indexSize = head.vertexCount < std::numeric_limits<uint16_t>::max() ?
+        sizeof(uint16_t) : sizeof(uint32_t);
+
+      head.jointSize = sizeof(uint32_t);
+      head.weightSize = sizeof(float);
+      if (head.hasWeights && options.compactSkinning)
+      {
+        uint32_t maxJoint{ 0 };
+        for (auto const& joint : mesh.joints)
+          maxJoint = std::max({ maxJoint, joint.x, joint.y, joint.z, joint.w });
+
+        // Rigs with more joints than u16 can index keep 32 bit joints
+        head.jointSize =
+          maxJoint <= std::numeric_limits<uint8_t>::max() ? sizeof(uint8_t) :
+          maxJoint <= std::numeric_limits<uint16_t>::max() ? sizeof(uint16_t) :
+          sizeof(uint32_t);
+        head.weightSize = options.skinWeightBits == 16 ? sizeof(uint16_t) : sizeof(uint8_t);
+      }
+
+      head.bounds = mesh.hasSourceBounds ? mesh.sourceBounds : BoundingVolumes::ComputeBox(mesh.vertexPosition);
+
+      // Declared bounds spare the position scan, the sphere is then the
+      // box's. Otherwise Ritter's, unless it ends up looser than the box's
+      // on boxy meshes.
+      auto const boxSphere{ BoundingVolumes::SphereOfBox(head.bounds) };
+      if (mesh.hasSourceBounds)
+      {
+        head.boundingSphere = boxSphere;
+      }
+      else
+      {
+        auto const sphere{ BoundingVolumes::ComputeSphere(mesh.vertexPosition) };
+        head.boundingSphere = sphere.radius <= boxSphere.radius ? sphere : boxSphere;
+      }
+
+      if (i == 0)
+      {
+        asset.header.bounds = head.bounds;
+        asset.header.boundingSphere = head.boundingSphere;
+      }
+      else
+      {
+        asset.header.bounds = BoundingVolumes::Merge(asset.header.bounds, head.bounds);
+        asset.header.boundingSphere = BoundingVolumes::Merge(asset.header.boundingSphere, head.boundingSphere);
+      }
+
+      head.vertexEncoding = 0;
+      if (options.quantisePositions)
+      {
+        head.vertexEncoding |= VERTEX_ENCODING_POSITION_UNORM16;
+        VertexQuantisation::ComputePositionRange(mesh.vertexPosition, head.positionOffset, head.positionScale);
+      }
+      if (options.quantiseNormals)
+        head.vertexEncoding |= VERTEX_ENCODING_NORMAL_OCT16;
+      if (options.quantiseTexCoords)
+        head.vertexEncoding |= VERTEX_ENCODING_TEXCOORD_HALF;
     }
 
     // Anim Headers
@@ -220,36 +690,98 @@ namespace SH_COMP
 
       head.charCount = anim.name.size();
       head.animNodeCount = anim.nodes.size();
-      head.frameCount = anim.nodes[0].positionKeys.size();
+      head.frameCount = 0;
+      for (auto const& node : anim.nodes)
+      {
+        head.frameCount = std::max({
+          head.frameCount,
+          static_cast<uint32_t>(node.positionKeys.size()),
+          static_cast<uint32_t>(node.rotationKeys.size()),
+          static_cast<uint32_t>(node.scaleKeys.size())
+        });
+      }
+
+      head.keyEncoding = anim.quantisedNodes.empty() ? 0 : KEY_ENCODING_QUANTISED;
+      if (SampleRate(anim.name) > 0.f)
+        head.keyEncoding |= KEY_ENCODING_UNIFORM;
+
+      head.timelineCount = anim.timelines.size();
+      head.timeCount = anim.times.size();
+      head.positionCount = head.rotationCount = head.scaleCount = 0;
+      for (auto const& node : anim.nodeHeaders)
+      {
+        auto const countOf = [&anim](AnimChannel const& channel) -> uint32_t
+        {
+          return channel.timeline == NO_TIMELINE ? 0 : anim.timelines[channel.timeline].count;
+        };
+
+        head.positionCount += countOf(node.position);
+        head.rotationCount += countOf(node.rotation);
+        head.scaleCount += countOf(node.scale);
+      }
     }
   }
 
-  inline void MeshCompiler::LoadAndCompile(AssetPath path) noexcept
+  inline bool MeshCompiler::LoadAndCompile(AssetPath path, CompileOptions const& options, std::ostream& log) noexcept
   {
+    auto const cacheKey{ BuildCache::ComputeKey(path, options, log) };
+    if (options.useCache && BuildCache::IsUpToDate(path, cacheKey))
+    {
+	    log << "[Model Compiler] Up to date: " << path << "\n\n";
+      return true;
+    }
+
+    MeshCompiler compiler{ options, log };
     auto const asset = new ModelAsset();
+    bool result{ false };
 
-    if (LoadFromFile(path, *asset))
+    if (compiler.LoadFromFile(path, *asset))
     {
-	    BuildHeaders(*asset);
-	    MeshWriter::CompileMeshBinary(path, *asset);
-			std::cout << "[Model Compiler] Compiled file: " << path << "\n\n";
+      compiler.OptimiseMeshes(*asset);
+      compiler.OptimiseAnimations(*asset);
+	    compiler.BuildHeaders(*asset);
+	    result = MeshWriter::CompileMeshBinary(path, *asset, log);
+
+      if (result && options.verifyOutput)
+      {
+        auto const start{ std::chrono::steady_clock::now() };
+        ModelView view;
+        result = view.Open(MeshWriter::GetOutputPath(path), true, log);
+        auto const elapsed{ std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start) };
+
+        if (result)
+          log << "[Model Compiler] Verified output, validated load in " << elapsed.count() << " us\n";
+      }
     }
+
+    BuildCache::Store(path, result ? cacheKey : BuildCache::INVALID_KEY);
+
+    if (result)
+			log << "[Model Compiler] Compiled file: " << path << "\n\n";
     else
-    {
-	    std::cout << "[Model Compiler] Failed to compile file: " << path << "\n\n";
-    }
+	    log << "[Model Compiler] Failed to compile file: " << path << "\n\n";
 
     delete asset;
+    return result;
   }
 
-  inline void MeshCompiler::ProcessAnimationChannels(ModelData const& data, ModelRef asset) noexcept
+  inline void MeshCompiler::ProcessAnimationChannels(ModelData const& data, ModelRef asset)
   {
     if (data.animations.empty())
     {
-	    std::cout << "[Model Compiler] Animations do not exist\n";
+	    log << "[Model Compiler] Animations do not exist\n";
       return;
     }
 
+    auto const interpolationMode = [](std::string const& name)
+    {
+      return
+        name == LINEAR_INTERPOLATION.data() ? AnimationInterpolation::LINEAR :
+        name == STEP_INTERPOLATION.data() ? AnimationInterpolation::STEP :
+        name == CUBICSPLINE_INTERPOLATION.data() ? AnimationInterpolation::CUBICSPLINE :
+        AnimationInterpolation::DEFAULT;
+    };
+
     asset.anims.resize(data.animations.size());
     for (auto i {0}; i < data.animations.size(); ++i)
     {
@@ -258,39 +790,98 @@ namespace SH_COMP
 
       anim.name = animData.name;
 
+      // Samplers are often shared by several channels, read each once
+      std::vector<AnimationSampler::Curve> curves(animData.samplers.size());
+      for (size_t j{ 0 }; j < animData.samplers.size(); ++j)
+      {
+        auto const& sampler{ animData.samplers[j] };
+        FetchData(sampler.input, curves[j].times);
+        FetchData(sampler.output, curves[j].outputs);
+        curves[j].interpolation = interpolationMode(sampler.interpolation);
+      }
+
+      // Channels end independently, the clip lasts until the last of them
+      double seconds{ 0.0 };
       for (auto const& channel : animData.channels)
       {
-        auto const& sampler{ animData.samplers[channel.sampler] };
+        auto const& times{ curves[channel.sampler].times };
+        if (!times.empty())
+          seconds = std::max(seconds, static_cast<double>(times.back()));
+      }
+
+      float const sampleRate{ SampleRate(anim.name) };
+      auto const sampleCount{ sampleRate > 0.f ? AnimationSampler::SampleCount(seconds, sampleRate) : 0 };
+
+      // Resampled nodes hold their keys only if every channel does
+      std::vector<bool> stepped;
+      bool cubic{ false };
+
+      for (auto const& channel : animData.channels)
+      {
+        auto const& curve{ curves[channel.sampler] };
         auto const& targetNode{asset.nodeIndexMap[channel.target_node]};
 
         // Resize nodes vector to latest largest index called
         if (anim.nodes.size() <= targetNode)
+        {
           anim.nodes.resize(targetNode + 1);
+          stepped.resize(targetNode + 1, true);
+        }
         
         if (channel.target_path == TRANSLATION_PATH.data())
-          FetchChannelKeyFrame(sampler.input, sampler.output, anim.nodes[targetNode].positionKeys);
+          FetchChannelKeyFrame(curve, sampleRate, sampleCount, anim.nodes[targetNode].positionKeys);
         else if (channel.target_path == SCALE_PATH.data())
-          FetchChannelKeyFrame(sampler.input, sampler.output, anim.nodes[targetNode].scaleKeys);
+          FetchChannelKeyFrame(curve, sampleRate, sampleCount, anim.nodes[targetNode].scaleKeys);
         else if (channel.target_path == ROTATION_PATH.data())
-          FetchChannelKeyFrame(sampler.input, sampler.output, anim.nodes[targetNode].rotationKeys);
+          FetchChannelKeyFrame(curve, sampleRate, sampleCount, anim.nodes[targetNode].rotationKeys);
+
+        anim.nodes[targetNode].interpolation = curve.interpolation;
+        stepped[targetNode] = stepped[targetNode] && curve.interpolation == AnimationInterpolation::STEP;
+        cubic = cubic || curve.interpolation == AnimationInterpolation::CUBICSPLINE;
+      }
+
+      // Only key values are written, so without tangents the curve can only
+      // be claimed as LINEAR between them
+      if (cubic && sampleRate <= 0.f)
+      {
+        for (auto& node : anim.nodes)
+        {
+          if (node.interpolation == AnimationInterpolation::CUBICSPLINE)
+            node.interpolation = AnimationInterpolation::LINEAR;
+        }
 
-        anim.nodes[targetNode].interpolation =
-	        sampler.interpolation == LINEAR_INTERPOLATION.data() ? AnimationInterpolation::LINEAR :
-	        sampler.interpolation == STEP_INTERPOLATION.data() ? AnimationInterpolation::STEP :
-	        sampler.interpolation == CUBICSPLINE_INTERPOLATION.data() ? AnimationInterpolation::CUBICSPLINE :
-	        AnimationInterpolation::DEFAULT;
+        log << "[Model Compiler] CUBICSPLINE tangents are not written, stored "
+          << anim.name << " as LINEAR, resample it to keep its curves\n";
       }
 
-      anim.duration = (anim.nodes[0].positionKeys.end() - 1)->time;
-      anim.ticksPerSecond = 1.f;
+      if (sampleRate > 0.f)
+      {
+        for (size_t j{ 0 }; j < anim.nodes.size(); ++j)
+        {
+          auto& node{ anim.nodes[j] };
+          bool const animated{ !node.positionKeys.empty() || !node.rotationKeys.empty() || !node.scaleKeys.empty() };
+          node.interpolation = animated && stepped[j] ? AnimationInterpolation::STEP : AnimationInterpolation::LINEAR;
+        }
+
+        anim.ticksPerSecond = sampleRate;
+        anim.duration = seconds * sampleRate;
+
+        log << "[Model Compiler] Resampled " << anim.name << ": " << sampleCount
+          << " keys per channel at " << sampleRate << " per second\n";
+      }
+      else
+      {
+        anim.ticksPerSecond = 1.0;
+        anim.duration = seconds;
+      }
     }
   }
 
-  inline void MeshCompiler::ProcessRigNodes(ModelData const& data, ModelRef asset) noexcept
+  inline void MeshCompiler::ProcessRigNodes(ModelData const& data, ModelRef asset)
   {
     if (data.skins.empty())
     {
-	    std::cout << "[Model Compiler] Skins not found for asset\n";
+	    log << "[Model Compiler] Skins not found for asset\n";
       return;
     }
        
@@ -0,0 +1,432 @@
+/******************************************************************************
+ * \file    MeshOptimiser.cpp
+ * \author  Loh Xiao Qi
+ * \brief   Optional passes run over compiled MeshData
+ * 
+ * \copyright	Copyright (c) 2022 Digipen Institute of Technology. Reproduction
+ *						or disclosure of this file or its contents without the prior
+ *						written consent of Digipen Institute of Technology is prohibited
+ ******************************************************************************/
+#include "MeshOptimiser.h"
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cstring>
+#include <span>
+#include <unordered_map>
+
+namespace SH_COMP
+{
+  namespace
+  {
+    constexpr int32_t NO_VERTEX{ -1 };
+
+    // Triangles touching each vertex, as a flat list with per vertex offsets
+    struct VertexAdjacency
+    {
+      std::vector<uint32_t> offsets;
+      std::vector<uint32_t> triangles;
+
+      VertexAdjacency(std::span<IndexType const> indices, size_t vertexCount)
+        : offsets(vertexCount + 1, 0), triangles(indices.size())
+      {
+        for (auto const index : indices)
+          ++offsets[index + 1];
+
+        for (size_t i{ 1 }; i < offsets.size(); ++i)
+          offsets[i] += offsets[i - 1];
+
+        std::vector<uint32_t> cursor{ offsets.begin(), offsets.end() - 1 };
+        for (size_t i{ 0 }; i < indices.size(); ++i)
+          triangles[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+      }
+
+      std::span<uint32_t const> Of(IndexType vertex) const noexcept
+      {
+        return { triangles.data() + offsets[vertex], triangles.data() + offsets[vertex + 1] };
+      }
+    };
+
+    /***************************************************************************
+     * Tipsify, Sander et al. 2007. Fans around the most recently cached vertex
+     * that will still be in the cache once its remaining triangles are emitted.
+     ***************************************************************************/
+    std::vector<IndexType> Tipsify(std::span<IndexType const> indices, size_t vertexCount, uint32_t cacheSize)
+    {
+      auto const triangleCount{ indices.size() / 3 };
+      VertexAdjacency const adjacency{ indices, vertexCount };
+
+      std::vector<uint32_t> liveTriangles(vertexCount, 0);
+      for (auto const index : indices)
+        ++liveTriangles[index];
+
+      std::vector<uint32_t> cacheTime(vertexCount, 0);
+      std::vector<bool> emitted(triangleCount, false);
+      std::vector<IndexType> deadEnd;
+      std::vector<IndexType> candidates;
+      std::vector<IndexType> result;
+      result.reserve(indices.size());
+
+      // Cursor only needs to walk vertices this index range references
+      auto const [minIt, maxIt] { std::ranges::minmax_element(indices) };
+      auto cursor{ static_cast<size_t>(*minIt) };
+      auto const cursorEnd{ static_cast<size_t>(*maxIt) + 1 };
+
+      uint32_t time{ cacheSize + 1 };
+      int32_t fanning{ static_cast<int32_t>(indices[0]) };
+
+      while (fanning != NO_VERTEX)
+      {
+        candidates.clear();
+
+        for (auto const triangle : adjacency.Of(static_cast<IndexType>(fanning)))
+        {
+          if (emitted[triangle])
+            continue;
+
+          for (auto corner{ 0 }; corner < 3; ++corner)
+          {
+            auto const vertex{ indices[triangle * 3 + corner] };
+            result.push_back(vertex);
+            deadEnd.push_back(vertex);
+            candidates.push_back(vertex);
+            --liveTriangles[vertex];
+
+            if (time - cacheTime[vertex] > cacheSize)
+              cacheTime[vertex] = time++;
+          }
+
+          emitted[triangle] = true;
+        }
+
+        // Best candidate stays in cache after fanning its live triangles
+        fanning = NO_VERTEX;
+        int64_t bestPriority{ -1 };
+        for (auto const vertex : candidates)
+        {
+          if (liveTriangles[vertex] == 0)
+            continue;
+
+          int64_t priority{ 0 };
+          if (time - cacheTime[vertex] + 2 * liveTriangles[vertex] <= cacheSize)
+            priority = time - cacheTime[vertex];
+
+          if (priority > bestPriority)
+          {
+            bestPriority = priority;
+            fanning = static_cast<int32_t>(vertex);
+          }
+        }
+
+        if (fanning != NO_VERTEX)
+          continue;
+
+        // Dead end, fall back to recently used vertices then to a linear scan
+        while (!deadEnd.empty() && fanning == NO_VERTEX)
+        {
+          auto const vertex{ deadEnd.back() };
+          deadEnd.pop_back();
+          if (liveTriangles[vertex] > 0)
+            fanning = static_cast<int32_t>(vertex);
+        }
+
+        for (; cursor < cursorEnd && fanning == NO_VERTEX; ++cursor)
+        {
+          if (liveTriangles[cursor] > 0)
+            fanning = static_cast<int32_t>(cursor);
+        }
+      }
+
+      return result;
+    }
+  }
+
+  VertexCacheStats MeshOptimiser::AnalyseVertexCache(MeshData const& mesh, uint32_t cacheSize) noexcept
+  {
+    auto const vertexCount{ mesh.vertexPosition.size() };
+    auto const triangleCount{ mesh.indices.size() / 3 };
+    if (triangleCount == 0 || vertexCount == 0)
+      return { 0.f, 0.f };
+
+    // FIFO cache, a vertex is resident if it entered within the last cacheSize misses
+    std::vector<uint64_t> entered(vertexCount, 0);
+    uint64_t misses{ 0 };
+    size_t referenced{ 0 };
+
+    for (auto const index : mesh.indices)
+    {
+      auto& stamp{ entered[index] };
+      if (stamp == 0)
+        ++referenced;
+
+      if (stamp == 0 || misses - stamp >= cacheSize)
+        stamp = ++misses;
+    }
+
+    return {
+      static_cast<float>(misses) / triangleCount,
+      static_cast<float>(misses) / referenced
+    };
+  }
+
+  void MeshOptimiser::OptimiseVertexCache(MeshData& mesh, uint32_t cacheSize) noexcept
+  {
+    auto const vertexCount{ mesh.vertexPosition.size() };
+    for (auto const& subMesh : mesh.subMeshes)
+    {
+      auto const triangleIndexCount{ subMesh.indexCount - subMesh.indexCount % 3 };
+      if (triangleIndexCount == 0)
+        continue;
+
+      std::span<IndexType> range{ mesh.indices.data() + subMesh.indexOffset, triangleIndexCount };
+      auto const reordered{ Tipsify(range, vertexCount, cacheSize) };
+      std::ranges::copy(reordered, range.begin());
+    }
+
+    for (auto const& lodSubMesh : mesh.lodSubMeshes)
+    {
+      if (lodSubMesh.indexCount < 3)
+        continue;
+
+      std::span<IndexType> range{ mesh.lodIndices.data() + lodSubMesh.indexOffset, lodSubMesh.indexCount - lodSubMesh.indexCount % 3 };
+      auto const reordered{ Tipsify(range, vertexCount, cacheSize) };
+      std::ranges::copy(reordered, range.begin());
+    }
+  }
+
+  size_t MeshOptimiser::WeldVertices(MeshData& mesh, float epsilon) noexcept
+  {
+    auto const vertexCount{ mesh.vertexPosition.size() };
+    if (vertexCount == 0)
+      return 0;
+
+    // Flatten every stream of a vertex into one key of 32 bit lanes
+    auto const lanesOf = [vertexCount](auto const& stream)->size_t
+    {
+      using Element = typename std::remove_reference_t<decltype(stream)>::value_type;
+      return stream.size() == vertexCount ? sizeof(Element) / sizeof(uint32_t) : 0;
+    };
+
+    auto const laneCount{
+      lanesOf(mesh.vertexPosition) + lanesOf(mesh.vertexTangent) + lanesOf(mesh.vertexNormal) +
+      lanesOf(mesh.texCoords) + lanesOf(mesh.weights) + lanesOf(mesh.joints)
+    };
+
+    std::vector<uint32_t> vertexKeys(vertexCount * laneCount);
+    std::vector<bool> floatLanes(laneCount, false);
+    size_t laneOffset{ 0 };
+    auto const addLanes = [&](auto const& stream, bool isFloat)
+    {
+      auto const lanes{ lanesOf(stream) };
+      for (size_t i{ 0 }; i < vertexCount && lanes > 0; ++i)
+        std::memcpy(vertexKeys.data() + i * laneCount + laneOffset, &stream[i], lanes * sizeof(uint32_t));
+
+      std::fill_n(floatLanes.begin() + laneOffset, lanes, isFloat);
+      laneOffset += lanes;
+    };
+
+    addLanes(mesh.vertexPosition, true);
+    addLanes(mesh.vertexTangent, true);
+    addLanes(mesh.vertexNormal, true);
+    addLanes(mesh.texCoords, true);
+    addLanes(mesh.weights, true);
+    addLanes(mesh.joints, false);
+
+    auto const keyOf = [&](size_t vertex)
+    {
+      return std::span<uint32_t const>{ vertexKeys.data() + vertex * laneCount, laneCount };
+    };
+
+    std::vector<IndexType> remap(vertexCount);
+    IndexType uniqueCount{ 0 };
+
+    if (epsilon > 0.f)
+    {
+      // Float lanes within epsilon of the representative's, others identical
+      auto const welds = [&](size_t vertex, size_t representative)
+      {
+        auto const key{ keyOf(vertex) };
+        auto const other{ keyOf(representative) };
+        for (size_t lane{ 0 }; lane < laneCount; ++lane)
+        {
+          if (!floatLanes[lane])
+          {
+            if (key[lane] != other[lane])
+              return false;
+            continue;
+          }
+
+          float lhs, rhs;
+          std::memcpy(&lhs, &key[lane], sizeof(float));
+          std::memcpy(&rhs, &other[lane], sizeof(float));
+          if (!(std::abs(lhs - rhs) <= epsilon) && key[lane] != other[lane])
+            return false;
+        }
+
+        return true;
+      };
+
+      // Representatives are bucketed by position into epsilon sized cells.
+      // A vertex within epsilon of one lies in the same or an adjacent cell,
+      // so the 27 cells around a vertex hold every candidate.
+      auto const cellOf = [epsilon](float value)->int64_t
+      {
+        constexpr double CELL_LIMIT{ 1ll << 40 };
+        double const cell{ std::floor(static_cast<double>(value) / epsilon) };
+        return static_cast<int64_t>(std::isnan(cell) ? 0.0 : std::clamp(cell, -CELL_LIMIT, CELL_LIMIT));
+      };
+
+      auto const cellHash = [](int64_t x, int64_t y, int64_t z)
+      {
+        uint64_t hash{ 0xcbf29ce484222325ull };
+        for (auto const coordinate : { x, y, z })
+          hash = (hash ^ static_cast<uint64_t>(coordinate)) * 0x100000001b3ull;
+        return hash;
+      };
+
+      std::unordered_map<uint64_t, std::vector<IndexType>> cells;
+      for (size_t i{ 0 }; i < vertexCount; ++i)
+      {
+        auto const& position{ mesh.vertexPosition[i] };
+        int64_t const x{ cellOf(position.x) }, y{ cellOf(position.y) }, z{ cellOf(position.z) };
+
+        int64_t representative{ -1 };
+        for (int64_t dx{ -1 }; dx <= 1 && representative < 0; ++dx)
+        {
+          for (int64_t dy{ -1 }; dy <= 1 && representative < 0; ++dy)
+          {
+            for (int64_t dz{ -1 }; dz <= 1 && representative < 0; ++dz)
+            {
+              auto const cell{ cells.find(cellHash(x + dx, y + dy, z + dz)) };
+              if (cell == cells.end())
+                continue;
+
+              for (auto const candidate : cell->second)
+              {
+                if (welds(i, candidate))
+                {
+                  representative = candidate;
+                  break;
+                }
+              }
+            }
+          }
+        }
+
+        if (representative >= 0)
+        {
+          remap[i] = remap[representative];
+        }
+        else
+        {
+          cells[cellHash(x, y, z)].push_back(static_cast<IndexType>(i));
+          remap[i] = uniqueCount++;
+        }
+      }
+    }
+    else
+    {
+      // Open addressing table of representative vertices, FNV-1a over the key
+      size_t tableSize{ 1 };
+      while (tableSize < vertexCount * 2)
+        tableSize <<= 1;
+
+      constexpr auto EMPTY{ std::numeric_limits<IndexType>::max() };
+      std::vector<IndexType> table(tableSize, EMPTY);
+
+      for (size_t i{ 0 }; i < vertexCount; ++i)
+      {
+        auto const key{ keyOf(i) };
+        uint64_t hash{ 0xcbf29ce484222325ull };
+        for (auto const lane : key)
+          hash = (hash ^ lane) * 0x100000001b3ull;
+
+        auto slot{ static_cast<size_t>(hash) & (tableSize - 1) };
+        while (table[slot] != EMPTY && !std::ranges::equal(keyOf(table[slot]), key))
+          slot = (slot + 1) & (tableSize - 1);
+
+        if (table[slot] == EMPTY)
+        {
+          table[slot] = static_cast<IndexType>(i);
+          remap[i] = uniqueCount++;
+        }
+        else
+        {
+          remap[i] = remap[table[slot]];
+        }
+      }
+    }
+
+    if (uniqueCount < vertexCount)
+      RemapVertices(mesh, remap, uniqueCount);
+
+    return uniqueCount;
+  }
+
+  void MeshOptimiser::OptimiseVertexFetch(MeshData& mesh) noexcept
+  {
+    auto const vertexCount{ mesh.vertexPosition.size() };
+    constexpr auto UNUSED{ std::numeric_limits<IndexType>::max() };
+
+    std::vector<IndexType> remap(vertexCount, UNUSED);
+    IndexType next{ 0 };
+    for (auto const index : mesh.indices)
+    {
+      if (remap[index] == UNUSED)
+        remap[index] = next++;
+    }
+
+    for (auto& slot : remap)
+    {
+      if (slot == UNUSED)
+        slot = next++;
+    }
+
+    RemapVertices(mesh, remap, vertexCount);
+  }
+
+  void MeshOptimiser::RemapVertices(MeshData& mesh, std::vector<IndexType> const& remap, size_t newVertexCount) noexcept
+  {
+    auto const permute = [&remap, newVertexCount](auto& stream)
+    {
+      if (stream.empty())
+        return;
+
+      std::remove_reference_t<decltype(stream)> result(newVertexCount);
+      std::vector<bool> written(newVertexCount, false);
+      for (size_t i{ 0 }; i < stream.size(); ++i)
+      {
+        if (written[remap[i]])
+          continue;
+
+        result[remap[i]] = stream[i];
+        written[remap[i]] = true;
+      }
+
+      stream = std::move(result);
+    };
+
+    permute(mesh.vertexPosition);
+    permute(mesh.vertexTangent);
+    permute(mesh.vertexNormal);
+    permute(mesh.texCoords);
+    permute(mesh.weights);
+    permute(mesh.joints);
+
+    for (auto& index : mesh.indices)
+    {
+      index = remap[index];
+    }
+
+    for (auto& index : mesh.lodIndices)
+    {
+      index = remap[index];
+    }
+
+    for (auto& vertex : mesh.meshletVertices)
+    {
+      vertex = remap[vertex];
+    }
+  }
+}
@@ -0,0 +1,54 @@
+/******************************************************************************
+ * \file    MeshOptimiser.h
+ * \author  Loh Xiao Qi
+ * \brief   Optional passes run over compiled MeshData before headers are
+ *					built, to improve how the GPU consumes the vertex and index
+ *					streams
+ * 
+ * \copyright	Copyright (c) 2022 Digipen Institute of Technology. Reproduction
+ *						or disclosure of this file or its contents without the prior
+ *						written consent of Digipen Institute of Technology is prohibited
+ ******************************************************************************/
+#pragma once
+
+#include "Types/MeshAsset.h"
+
+namespace SH_COMP
+{
+	// Post transform cache efficiency of an index buffer, simulated as FIFO
+	struct VertexCacheStats
+	{
+		// Average cache miss ratio, transformed vertices per triangle
+		float acmr;
+		// Average transformed vertex ratio, transformed vertices per vertex
+		float atvr;
+	};
+
+	struct MeshOptimiser
+	{
+		static constexpr uint32_t VERTEX_CACHE_SIZE{ 16 };
+
+		static VertexCacheStats AnalyseVertexCache(MeshData const& mesh, uint32_t cacheSize = VERTEX_CACHE_SIZE) noexcept;
+
+		// Tipsify triangle reordering, applied within each submesh range of the
+		// full mesh and of every LOD
+		static void OptimiseVertexCache(MeshData& mesh, uint32_t cacheSize = VERTEX_CACHE_SIZE) noexcept;
+
+		/*************************************************************************
+		 * Collapses vertices that are identical across every vertex stream and
+		 * rebuilds the indices. With epsilon above 0, a vertex instead welds to
+		 * the first earlier kept vertex whose float components are all within
+		 * epsilon of its own, joints always compare exactly. Returns the new
+		 * vertex count.
+		 *************************************************************************/
+		static size_t WeldVertices(MeshData& mesh, float epsilon = 0.f) noexcept;
+
+		// Permutes every vertex stream into first use order of the indices so
+		// vertex fetch walks memory linearly. Unreferenced vertices move to the end.
+		static void OptimiseVertexFetch(MeshData& mesh) noexcept;
+
+	private:
+		// remap[old] = new, vertices mapped to the same slot keep the first written
+		static void RemapVertices(MeshData& mesh, std::vector<IndexType> const& remap, size_t newVertexCount) noexcept;
+	};
+}
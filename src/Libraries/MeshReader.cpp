@@ -0,0 +1,485 @@
+/******************************************************************************
+ * \file    MeshReader.cpp
+ * \author  Loh Xiao Qi
+ * \brief   Zero copy reader for .shmodel files written by MeshWriter
+ *
+ * \copyright	Copyright (c) 2022 Digipen Institute of Technology. Reproduction
+ *						or disclosure of this file or its contents without the prior
+ *						written consent of Digipen Institute of Technology is prohibited
+ ******************************************************************************/
+#include "MeshReader.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace SH_COMP
+{
+  namespace
+  {
+    constexpr size_t AlignUp(size_t offset, size_t alignment) noexcept
+    {
+      return (offset + alignment - 1) / alignment * alignment;
+    }
+
+    // Hands out consecutive, aligned ranges of a section. Offsets are relative
+    // to the section, whose start is at least as aligned as any range.
+    struct SectionCursor
+    {
+      MappedBytes bytes;
+      size_t offset{ 0 };
+      bool overrun{ false };
+
+      MappedBytes Take(size_t size, size_t alignment = 1) noexcept
+      {
+        auto const begin{ AlignUp(offset, alignment) };
+        if (overrun || begin > bytes.size() || size > bytes.size() - begin)
+        {
+          overrun = true;
+          return {};
+        }
+
+        offset = begin + size;
+        return bytes.subspan(begin, size);
+      }
+
+      template <typename T>
+      std::span<T const> TakeArray(size_t count) noexcept
+      {
+        return MeshView::As<T>(Take(count * sizeof(T), MODEL_STREAM_ALIGNMENT));
+      }
+
+      // Copies out values that are not aligned in the file
+      template <typename T>
+      bool Read(T& value) noexcept
+      {
+        auto const source{ Take(sizeof(T)) };
+        if (overrun)
+          return false;
+
+        std::memcpy(&value, source.data(), sizeof(T));
+        return true;
+      }
+
+      bool Complete() const noexcept
+      {
+        return !overrun && offset == bytes.size();
+      }
+    };
+
+    template <typename T>
+    bool IndicesBelow(MappedBytes bytes, size_t limit) noexcept
+    {
+      return std::ranges::all_of(MeshView::As<T>(bytes), [limit](T index) { return index < limit; });
+    }
+
+    bool IndicesBelow(MappedBytes bytes, uint8_t indexSize, size_t limit) noexcept
+    {
+      return indexSize == sizeof(uint16_t) ?
+        IndicesBelow<uint16_t>(bytes, limit) :
+        IndicesBelow<uint32_t>(bytes, limit);
+    }
+  }
+
+  bool ModelView::Section(FileSection const& section, size_t alignment, MappedBytes& bytes) const noexcept
+  {
+    auto const fileBytes{ file.Bytes() };
+    if (section.offset > fileBytes.size() || section.size > fileBytes.size() - section.offset)
+      return false;
+
+    if (section.size > 0 && section.offset % alignment != 0)
+      return false;
+
+    bytes = fileBytes.subspan(section.offset, section.size);
+    return true;
+  }
+
+  bool ModelView::ReadMesh(MeshDataHeader const& meshHeader, MeshSections const& meshSections, MeshView& view) const noexcept
+  {
+    view = {};
+    view.header = &meshHeader;
+
+    MappedBytes body, vertices, indices, subMeshes, skinning, meshlets, lods, lodIndices;
+    if (!Section(meshSections.body, MODEL_SECTION_ALIGNMENT, body) ||
+      !Section(meshSections.vertices, MODEL_STREAM_ALIGNMENT, vertices) ||
+      !Section(meshSections.indices, MODEL_STREAM_ALIGNMENT, indices) ||
+      !Section(meshSections.subMeshes, MODEL_STREAM_ALIGNMENT, subMeshes) ||
+      !Section(meshSections.skinning, MODEL_STREAM_ALIGNMENT, skinning) ||
+      !Section(meshSections.meshlets, MODEL_STREAM_ALIGNMENT, meshlets) ||
+      !Section(meshSections.lods, MODEL_STREAM_ALIGNMENT, lods) ||
+      !Section(meshSections.lodIndices, MODEL_STREAM_ALIGNMENT, lodIndices))
+      return false;
+
+    auto const validSize = [](uint8_t size) { return size == 1 || size == 2 || size == 4; };
+    if (meshHeader.indexSize != sizeof(uint16_t) && meshHeader.indexSize != sizeof(uint32_t))
+      return false;
+    if (meshHeader.hasWeights > 1 ||
+      (meshHeader.hasWeights && !(validSize(meshHeader.jointSize) && validSize(meshHeader.weightSize))))
+      return false;
+
+    if (body.size() < meshHeader.charCount)
+      return false;
+    view.name = { reinterpret_cast<char const*>(body.data()), meshHeader.charCount };
+
+    size_t const vertexCount{ meshHeader.vertexCount };
+    auto const encoding{ meshHeader.vertexEncoding };
+
+    SectionCursor vertexCursor{ vertices };
+    view.positions = vertexCursor.Take(
+      vertexCount * (encoding & VERTEX_ENCODING_POSITION_UNORM16 ? sizeof(QuantisedPosition) : sizeof(SHVec3)),
+      MODEL_STREAM_ALIGNMENT
+    );
+
+    auto const directionSize{ encoding & VERTEX_ENCODING_NORMAL_OCT16 ? sizeof(OctahedralVector) : sizeof(SHVec3) };
+    view.tangents = vertexCursor.Take(vertexCount * directionSize, MODEL_STREAM_ALIGNMENT);
+    view.normals = vertexCursor.Take(vertexCount * directionSize, MODEL_STREAM_ALIGNMENT);
+    view.texCoords = vertexCursor.Take(
+      vertexCount * (encoding & VERTEX_ENCODING_TEXCOORD_HALF ? sizeof(HalfVec2) : sizeof(SHVec2)),
+      MODEL_STREAM_ALIGNMENT
+    );
+
+    SectionCursor indexCursor{ indices };
+    view.indices = indexCursor.Take(size_t{ meshHeader.indexCount } * meshHeader.indexSize);
+
+    SectionCursor subMeshCursor{ subMeshes };
+    view.subMeshes = subMeshCursor.TakeArray<SubMesh>(meshHeader.subMeshCount);
+
+    SectionCursor skinningCursor{ skinning };
+    if (meshHeader.hasWeights)
+    {
+      view.weights = skinningCursor.Take(vertexCount * 4 * meshHeader.weightSize, MODEL_STREAM_ALIGNMENT);
+      view.joints = skinningCursor.Take(vertexCount * 4 * meshHeader.jointSize, MODEL_STREAM_ALIGNMENT);
+    }
+
+    SectionCursor meshletCursor{ meshlets };
+    if (meshHeader.meshletCount > 0)
+    {
+      view.meshlets = meshletCursor.TakeArray<Meshlet>(meshHeader.meshletCount);
+      view.meshletVertices = meshletCursor.TakeArray<uint32_t>(meshHeader.meshletVertexCount);
+      view.meshletTriangles = meshletCursor.TakeArray<uint8_t>(meshHeader.meshletTriangleSize);
+    }
+
+    SectionCursor lodCursor{ lods };
+    SectionCursor lodIndexCursor{ lodIndices };
+    if (meshHeader.lodCount > 0)
+    {
+      view.lods = lodCursor.TakeArray<MeshLod>(meshHeader.lodCount);
+      view.lodSubMeshes = lodCursor.TakeArray<IndexRange>(size_t{ meshHeader.lodCount } * meshHeader.subMeshCount);
+      view.lodIndices = lodIndexCursor.Take(size_t{ meshHeader.lodIndexCount } * meshHeader.indexSize);
+    }
+
+    return vertexCursor.Complete() && indexCursor.Complete() && subMeshCursor.Complete() &&
+      skinningCursor.Complete() && meshletCursor.Complete() && lodCursor.Complete() && lodIndexCursor.Complete();
+  }
+
+  bool ModelView::ReadAnim(AnimDataHeader const& animHeader, FileSection const& section, AnimView& view) const noexcept
+  {
+    view = {};
+    view.header = &animHeader;
+
+    MappedBytes clip;
+    if (!Section(section, MODEL_SECTION_ALIGNMENT, clip))
+      return false;
+
+    SectionCursor cursor{ clip };
+    auto const name{ cursor.Take(animHeader.charCount) };
+    view.name = { reinterpret_cast<char const*>(name.data()), name.size() };
+
+    cursor.Take(0, MODEL_STREAM_ALIGNMENT);
+    if (!cursor.Read(view.duration) || !cursor.Read(view.ticksPerSecond))
+      return false;
+
+    bool const quantised{ (animHeader.keyEncoding & KEY_ENCODING_QUANTISED) != 0 };
+
+    view.timelines = cursor.TakeArray<KeyTimeline>(animHeader.timelineCount);
+    view.times = cursor.TakeArray<float>(animHeader.timeCount);
+    view.nodes = cursor.TakeArray<AnimNodeHeader>(animHeader.animNodeCount);
+    if (quantised)
+      view.quantisedNodes = cursor.TakeArray<QuantisedNodeHeader>(animHeader.animNodeCount);
+
+    view.positions = cursor.Take(size_t{ animHeader.positionCount } * (quantised ? sizeof(QuantisedVector) : sizeof(SHVec3)), MODEL_STREAM_ALIGNMENT);
+    view.rotations = cursor.Take(size_t{ animHeader.rotationCount } * (quantised ? sizeof(QuantisedRotation) : sizeof(SHVec4)), MODEL_STREAM_ALIGNMENT);
+    view.scales = cursor.Take(size_t{ animHeader.scaleCount } * (quantised ? sizeof(QuantisedVector) : sizeof(SHVec3)), MODEL_STREAM_ALIGNMENT);
+
+    return cursor.Complete();
+  }
+
+  bool ModelView::ValidateAnim(AnimView const& view, std::ostream& log) const noexcept
+  {
+    auto const& animHeader{ *view.header };
+    auto const fail = [&](char const* problem)
+    {
+      log << "[Model Reader] " << problem << " in animation: " << view.name << "\n";
+      return false;
+    };
+
+    for (auto const& timeline : view.timelines)
+    {
+      if (size_t{ timeline.offset } + timeline.count > view.times.size())
+        return fail("Timeline out of range");
+
+      if (animHeader.keyEncoding & KEY_ENCODING_UNIFORM)
+      {
+        for (uint32_t i{ 0 }; i < timeline.count; ++i)
+        {
+          if (view.times[timeline.offset + i] != static_cast<float>(i))
+            return fail("Uniform key off its tick");
+        }
+      }
+    }
+
+    auto const channelInRange = [&](AnimChannel const& channel, uint32_t valueCount)
+    {
+      if (channel.timeline == NO_TIMELINE)
+        return true;
+
+      return channel.timeline < view.timelines.size() &&
+        size_t{ channel.offset } + view.timelines[channel.timeline].count <= valueCount;
+    };
+
+    for (auto const& node : view.nodes)
+    {
+      if (!channelInRange(node.position, animHeader.positionCount) ||
+        !channelInRange(node.rotation, animHeader.rotationCount) ||
+        !channelInRange(node.scale, animHeader.scaleCount))
+      {
+        return fail("Channel out of range");
+      }
+
+      auto const mode{ static_cast<uint8_t>(node.interpolation) };
+      if (mode < static_cast<uint8_t>(AnimationInterpolation::LINEAR) ||
+        mode > static_cast<uint8_t>(AnimationInterpolation::CUBICSPLINE))
+      {
+        return fail("Invalid interpolation");
+      }
+    }
+
+    return true;
+  }
+
+  bool ModelView::ValidateMesh(MeshView const& view, std::ostream& log) const noexcept
+  {
+    auto const& meshHeader{ *view.header };
+    auto const fail = [&](char const* problem)
+    {
+      log << "[Model Reader] " << problem << " in mesh: " << view.name << "\n";
+      return false;
+    };
+
+    if (!IndicesBelow(view.indices, meshHeader.indexSize, meshHeader.vertexCount))
+      return fail("Index out of range");
+
+    for (auto const& subMesh : view.subMeshes)
+    {
+      if (size_t{ subMesh.indexOffset } + subMesh.indexCount > meshHeader.indexCount)
+        return fail("Submesh index range out of range");
+      if (size_t{ subMesh.meshletOffset } + subMesh.meshletCount > meshHeader.meshletCount)
+        return fail("Submesh meshlet range out of range");
+    }
+
+    for (auto const& meshlet : view.meshlets)
+    {
+      if (size_t{ meshlet.vertexOffset } + meshlet.vertexCount > view.meshletVertices.size() ||
+        size_t{ meshlet.triangleOffset } + size_t{ meshlet.triangleCount } * 3 > view.meshletTriangles.size())
+        return fail("Meshlet range out of range");
+
+      auto const triangles{ view.meshletTriangles.subspan(meshlet.triangleOffset, size_t{ meshlet.triangleCount } * 3) };
+      if (!std::ranges::all_of(triangles, [&](uint8_t local) { return local < meshlet.vertexCount; }))
+        return fail("Meshlet triangle out of range");
+    }
+
+    if (!std::ranges::all_of(view.meshletVertices, [&](uint32_t vertex) { return vertex < meshHeader.vertexCount; }))
+      return fail("Meshlet vertex out of range");
+
+    for (auto const& lod : view.lods)
+    {
+      if (size_t{ lod.indexOffset } + lod.indexCount > meshHeader.lodIndexCount)
+        return fail("LOD index range out of range");
+    }
+
+    for (auto const& range : view.lodSubMeshes)
+    {
+      if (size_t{ range.indexOffset } + range.indexCount > meshHeader.lodIndexCount)
+        return fail("LOD submesh range out of range");
+    }
+
+    if (!IndicesBelow(view.lodIndices, meshHeader.indexSize, meshHeader.vertexCount))
+      return fail("LOD index out of range");
+
+    return true;
+  }
+
+  bool ModelView::Open(AssetPath const& path, bool validate, std::ostream& log) noexcept
+  {
+    header = nullptr;
+    sections = nullptr;
+    meshes.clear();
+    anims.clear();
+
+    file = MappedFile{ path };
+    auto const fail = [&](char const* problem)
+    {
+      log << "[Model Reader] " << problem << ": " << path << "\n";
+      file = MappedFile{};
+      sections = nullptr;
+      meshes.clear();
+      anims.clear();
+      return false;
+    };
+
+    if (!file.IsOpen())
+      return fail("Unable to map file");
+
+    // Mappings are page aligned, so the headers can be used in place
+    auto const bytes{ file.Bytes() };
+    if (bytes.size() < sizeof(ModelAssetHeader) + sizeof(ModelSections))
+      return fail("File too small");
+
+    auto const fileHeader{ reinterpret_cast<ModelAssetHeader const*>(bytes.data()) };
+    if (fileHeader->magic != MODEL_FILE_MAGIC)
+      return fail("Not a model file");
+    if (fileHeader->version != MODEL_COMPILER_VERSION)
+      return fail("Model file version mismatch");
+
+    auto const tableSize{
+      sizeof(ModelSections) +
+      sizeof(MeshSections) * size_t{ fileHeader->meshCount } +
+      sizeof(FileSection) * size_t{ fileHeader->animCount }
+    };
+    if (tableSize > bytes.size() - sizeof(ModelAssetHeader))
+      return fail("Section table out of range");
+
+    sections = reinterpret_cast<ModelSections const*>(bytes.data() + sizeof(ModelAssetHeader));
+    auto const meshSections{ reinterpret_cast<MeshSections const*>(sections + 1) };
+    auto const animSections{ reinterpret_cast<FileSection const*>(meshSections + fileHeader->meshCount) };
+
+    MappedBytes meshHeaderBytes, animHeaderBytes;
+    if (!Section(sections->meshHeaders, MODEL_SECTION_ALIGNMENT, meshHeaderBytes) ||
+      meshHeaderBytes.size() != sizeof(MeshDataHeader) * fileHeader->meshCount)
+      return fail("Mesh headers out of range");
+
+    if (!Section(sections->animHeaders, MODEL_STREAM_ALIGNMENT, animHeaderBytes) ||
+      animHeaderBytes.size() != sizeof(AnimDataHeader) * fileHeader->animCount)
+      return fail("Animation headers out of range");
+
+    auto const meshHeaders{ MeshView::As<MeshDataHeader>(meshHeaderBytes) };
+    meshes.resize(meshHeaders.size());
+    for (size_t i{ 0 }; i < meshes.size(); ++i)
+    {
+      if (!ReadMesh(meshHeaders[i], meshSections[i], meshes[i]))
+        return fail("Mesh data does not match its header");
+    }
+
+    auto const animHeaders{ MeshView::As<AnimDataHeader>(animHeaderBytes) };
+    anims.resize(animHeaders.size());
+    for (size_t i{ 0 }; i < anims.size(); ++i)
+    {
+      if (!ReadAnim(animHeaders[i], animSections[i], anims[i]))
+        return fail("Animation data does not match its header");
+    }
+
+    MappedBytes rigBytes;
+    if (!Section(sections->rig, MODEL_SECTION_ALIGNMENT, rigBytes))
+      return fail("Rig out of range");
+
+    if (validate)
+    {
+      for (auto const& mesh : meshes)
+      {
+        if (!ValidateMesh(mesh, log))
+          return fail("Invalid mesh data");
+      }
+
+      for (auto const& anim : anims)
+      {
+        if (!ValidateAnim(anim, log))
+          return fail("Invalid animation data");
+      }
+
+      RigData rig;
+      if (HasRig() && !ReadRig(rig))
+        return fail("Invalid rig");
+    }
+
+    header = fileHeader;
+    return true;
+  }
+
+  bool ModelView::HasRig() const noexcept
+  {
+    return sections != nullptr && sections->rig.size > 0;
+  }
+
+  bool ModelView::ReadRig(RigData& rig) const noexcept
+  {
+    MappedBytes bytes;
+    if (!HasRig() || !Section(sections->rig, MODEL_SECTION_ALIGNMENT, bytes))
+      return false;
+
+    SectionCursor cursor{ bytes };
+    auto& rigHeader{ rig.header };
+    if (!cursor.Read(rigHeader.nodeCount) || !cursor.Read(rigHeader.startNode))
+      return false;
+
+    // Every node costs at least its matrix and flags, bounding the count
+    if (rigHeader.nodeCount > bytes.size() / (sizeof(SHMat4) + sizeof(NodeDataFlag)))
+      return false;
+
+    rigHeader.charCounts.resize(rigHeader.nodeCount);
+    for (auto& charCount : rigHeader.charCounts)
+    {
+      if (!cursor.Read(charCount))
+        return false;
+    }
+
+    auto const readDoubles = [&cursor](std::vector<double>& values, size_t count)
+    {
+      auto const source{ cursor.Take(sizeof(double) * count) };
+      values.resize(cursor.overrun ? 0 : count);
+      if (!values.empty())
+        std::memcpy(values.data(), source.data(), source.size());
+    };
+
+    rig.nodes.clear();
+    rig.nodes.resize(rigHeader.nodeCount);
+    for (size_t i{ 0 }; i < rig.nodes.size(); ++i)
+    {
+      auto& node{ rig.nodes[i] };
+      auto const name{ cursor.Take(rigHeader.charCounts[i]) };
+      node.name.assign(reinterpret_cast<char const*>(name.data()), name.size());
+
+      NodeDataFlag flags{ 0 };
+      if (!cursor.Read(node.inverseBindMatrix) || !cursor.Read(flags))
+        return false;
+
+      readDoubles(node.rotation, flags & NODE_DATA_ROTATION ? 4 : 0);
+      readDoubles(node.scale, flags & NODE_DATA_SCALE ? 3 : 0);
+      readDoubles(node.translation, flags & NODE_DATA_TRANSLATION ? 3 : 0);
+      readDoubles(node.matrix, flags & NODE_DATA_MATRIX ? 16 : 0);
+    }
+
+    // Structure is breadth first from startNode as (node, child count) pairs,
+    // so the children of each entry are the next unclaimed entries
+    std::vector<std::pair<IndexType, uint32_t>> structure;
+    while (cursor.offset < bytes.size())
+    {
+      std::pair<IndexType, uint32_t> entry;
+      if (!cursor.Read(entry.first) || !cursor.Read(entry.second) || entry.first >= rigHeader.nodeCount)
+        return false;
+      structure.push_back(entry);
+    }
+
+    size_t nextChild{ 1 };
+    for (auto const& [nodeIndex, childCount] : structure)
+    {
+      if (childCount > structure.size() - nextChild)
+        return false;
+
+      auto& children{ rig.nodes[nodeIndex].children };
+      children.clear();
+      for (uint32_t c{ 0 }; c < childCount; ++c)
+        children.push_back(structure[nextChild++].first);
+    }
+
+    return !cursor.overrun;
+  }
+}
@@ -0,0 +1,139 @@
+/******************************************************************************
+ * \file    MeshReader.h
+ * \author  Loh Xiao Qi
+ * \brief   Zero copy reader for .shmodel files written by MeshWriter. The
+ *					file is mapped and every stream is exposed as a span into the
+ *					mapping.
+ *
+ * \copyright	Copyright (c) 2022 Digipen Institute of Technology. Reproduction
+ *						or disclosure of this file or its contents without the prior
+ *						written consent of Digipen Institute of Technology is prohibited
+ ******************************************************************************/
+#pragma once
+
+#include <iostream>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "AssetMacros.h"
+#include "MappedFile.h"
+#include "Types/ModelAsset.h"
+
+namespace SH_COMP
+{
+	/***************************************************************************
+	 * Streams of one mesh. Vertex, index and skinning streams are bytes, as
+	 * their element type depends on the header encodings. Use As<T>() with
+	 * the matching type, e.g. QuantisedPosition when vertexEncoding has
+	 * VERTEX_ENCODING_POSITION_UNORM16 and SHVec3 otherwise.
+	 ***************************************************************************/
+	struct MeshView
+	{
+		MeshDataHeader const* header;
+		std::string_view name;
+
+		MappedBytes positions;
+		MappedBytes tangents;
+		MappedBytes normals;
+		MappedBytes texCoords;
+		MappedBytes indices;
+		std::span<SubMesh const> subMeshes;
+
+		// Empty unless header->hasWeights
+		MappedBytes weights;
+		MappedBytes joints;
+
+		std::span<Meshlet const> meshlets;
+		std::span<uint32_t const> meshletVertices;
+		std::span<uint8_t const> meshletTriangles;
+
+		std::span<MeshLod const> lods;
+		std::span<IndexRange const> lodSubMeshes;
+		MappedBytes lodIndices;
+
+		template <typename T>
+		static std::span<T const> As(MappedBytes bytes) noexcept
+		{
+			return { reinterpret_cast<T const*>(bytes.data()), bytes.size() / sizeof(T) };
+		}
+	};
+
+	/***************************************************************************
+	 * One clip in its structure of arrays layout. A channel's key times are
+	 * Times(channel) and its values start at channel.offset in the matching
+	 * value stream. The value streams are bytes, use As<T>() with SHVec3 and
+	 * SHVec4, or QuantisedVector and QuantisedRotation when the header has
+	 * KEY_ENCODING_QUANTISED. KeyQuantisation decodes the latter.
+	 ***************************************************************************/
+	struct AnimView
+	{
+		AnimDataHeader const* header;
+		std::string_view name;
+		double duration;
+		double ticksPerSecond;
+
+		std::span<KeyTimeline const> timelines;
+		std::span<float const> times;
+		std::span<AnimNodeHeader const> nodes;
+
+		// Empty unless KEY_ENCODING_QUANTISED
+		std::span<QuantisedNodeHeader const> quantisedNodes;
+
+		MappedBytes positions;
+		MappedBytes rotations;
+		MappedBytes scales;
+
+		// Empty for channels without a timeline
+		std::span<float const> Times(AnimChannel const& channel) const noexcept
+		{
+			if (channel.timeline == NO_TIMELINE)
+				return {};
+
+			auto const& timeline{ timelines[channel.timeline] };
+			return times.subspan(timeline.offset, timeline.count);
+		}
+	};
+
+	class ModelView
+	{
+		MappedFile file;
+		ModelAssetHeader const* header{ nullptr };
+		ModelSections const* sections{ nullptr };
+
+		std::vector<MeshView> meshes;
+		std::vector<AnimView> anims;
+
+		// False if the section does not lie within the file or is misaligned
+		bool Section(FileSection const& section, size_t alignment, MappedBytes& bytes) const noexcept;
+
+		bool ReadMesh(MeshDataHeader const& meshHeader, MeshSections const& meshSections, MeshView& view) const noexcept;
+		bool ReadAnim(AnimDataHeader const& animHeader, FileSection const& section, AnimView& view) const noexcept;
+
+		bool ValidateMesh(MeshView const& view, std::ostream& log) const noexcept;
+		bool ValidateAnim(AnimView const& view, std::ostream& log) const noexcept;
+
+	public:
+		/*************************************************************************
+		 * Maps path and builds views over every mesh and animation clip. The
+		 * magic, version, section table and stream sizes are always checked,
+		 * which costs O(meshes + clips). With validate, contents are checked
+		 * too: index, submesh, meshlet and LOD ranges, animation channel
+		 * ranges, interpolation modes and uniform key times, and the rig,
+		 * which touches every index in the file.
+		 *************************************************************************/
+		bool Open(AssetPath const& path, bool validate = false, std::ostream& log = std::cout) noexcept;
+
+		bool IsOpen() const noexcept { return header != nullptr; }
+
+		ModelAssetHeader const& Header() const noexcept { return *header; }
+		std::span<MeshView const> Meshes() const noexcept { return meshes; }
+		std::span<AnimView const> Anims() const noexcept { return anims; }
+
+		bool HasRig() const noexcept;
+
+		// Rig nodes are packed without alignment, so they are copied out. Child
+		// lists are rebuilt from the breadth first structure block.
+		bool ReadRig(RigData& rig) const noexcept;
+	};
+}
@@ -0,0 +1,546 @@
+/******************************************************************************
+ * \file    MeshSimplifier.cpp
+ * \author  Loh Xiao Qi
+ * \brief   Quadric error metric simplification, Garland and Heckbert 1997
+ * 
+ * \copyright	Copyright (c) 2022 Digipen Institute of Technology. Reproduction
+ *						or disclosure of this file or its contents without the prior
+ *						written consent of Digipen Institute of Technology is prohibited
+ ******************************************************************************/
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <tuple>
+
+namespace SH_COMP
+{
+  namespace
+  {
+    // Open borders are held in place by planes through the edge, weighted
+    // well above the surface so silhouettes survive
+    constexpr double BORDER_WEIGHT{ 10.0 };
+
+    // Collapses that turn a face normal more than ~75 degrees are rejected
+    constexpr double MIN_NORMAL_COSINE{ 0.25 };
+
+    using Triangle = std::array<uint32_t, 3>;
+
+    struct Vec3d
+    {
+      double x, y, z;
+
+      Vec3d operator-(Vec3d const& rhs) const noexcept { return { x - rhs.x, y - rhs.y, z - rhs.z }; }
+      double Dot(Vec3d const& rhs) const noexcept { return x * rhs.x + y * rhs.y + z * rhs.z; }
+      Vec3d Cross(Vec3d const& rhs) const noexcept
+      {
+        return { y * rhs.z - z * rhs.y, z * rhs.x - x * rhs.z, x * rhs.y - y * rhs.x };
+      }
+      double Length() const noexcept { return std::sqrt(Dot(*this)); }
+    };
+
+    // Sum of squared distances to a set of weighted planes
+    struct Quadric
+    {
+      double a00, a01, a02, a03, a11, a12, a13, a22, a23, a33;
+      double weight;
+
+      void AddPlane(Vec3d const& n, double d, double w) noexcept
+      {
+        a00 += w * n.x * n.x; a01 += w * n.x * n.y; a02 += w * n.x * n.z; a03 += w * n.x * d;
+        a11 += w * n.y * n.y; a12 += w * n.y * n.z; a13 += w * n.y * d;
+        a22 += w * n.z * n.z; a23 += w * n.z * d;
+        a33 += w * d * d;
+        weight += w;
+      }
+
+      Quadric& operator+=(Quadric const& rhs) noexcept
+      {
+        a00 += rhs.a00; a01 += rhs.a01; a02 += rhs.a02; a03 += rhs.a03;
+        a11 += rhs.a11; a12 += rhs.a12; a13 += rhs.a13;
+        a22 += rhs.a22; a23 += rhs.a23;
+        a33 += rhs.a33;
+        weight += rhs.weight;
+        return *this;
+      }
+
+      // Weighted mean squared distance of p to the planes
+      double Error(Vec3d const& p) const noexcept
+      {
+        auto const sum{
+          a00 * p.x * p.x + 2.0 * a01 * p.x * p.y + 2.0 * a02 * p.x * p.z + 2.0 * a03 * p.x +
+          a11 * p.y * p.y + 2.0 * a12 * p.y * p.z + 2.0 * a13 * p.y +
+          a22 * p.z * p.z + 2.0 * a23 * p.z +
+          a33
+        };
+        return weight > 0.0 ? std::abs(sum) / weight : 0.0;
+      }
+    };
+
+    struct Edge
+    {
+      uint32_t a, b;
+      uint32_t triangle;
+
+      auto operator<=>(Edge const&) const noexcept = default;
+    };
+
+    struct Collapse
+    {
+      double cost;
+      uint32_t from, to;
+
+      auto operator<=>(Collapse const&) const noexcept = default;
+    };
+
+    // Result of simplifying one submesh down to one target
+    struct Level
+    {
+      std::vector<IndexType> indices;
+      double error;
+    };
+
+    /***************************************************************************
+     * Simplifies a single submesh. Works on local vertex ids, where every
+     * distinct referenced vertex (wedge) is one id and wedges sharing a
+     * position share a representative, the lowest id of that position.
+     ***************************************************************************/
+    class SubMeshSimplifier
+    {
+    public:
+      SubMeshSimplifier(std::span<IndexType const> indices, std::vector<SHVec3> const& positions)
+      {
+        std::vector<IndexType> sorted{ indices.begin(), indices.end() };
+        std::ranges::sort(sorted);
+        auto const [first, last] { std::ranges::unique(sorted) };
+        sorted.erase(first, last);
+        wedges = std::move(sorted);
+
+        auto const localOf = [this](IndexType vertex)
+        {
+          return static_cast<uint32_t>(std::ranges::lower_bound(wedges, vertex) - wedges.begin());
+        };
+
+        for (size_t i{ 0 }; i + 2 < indices.size(); i += 3)
+          triangles.push_back({ localOf(indices[i]), localOf(indices[i + 1]), localOf(indices[i + 2]) });
+
+        points.reserve(wedges.size());
+        for (auto const vertex : wedges)
+        {
+          auto const& p{ positions[vertex] };
+          points.push_back({ p.x, p.y, p.z });
+        }
+
+        // Group wedges by exact position bits
+        auto const bitsOf = [&](uint32_t local)
+        {
+          std::array<uint32_t, 3> bits;
+          std::memcpy(bits.data(), &positions[wedges[local]], sizeof(bits));
+          return bits;
+        };
+
+        std::vector<uint32_t> order(wedges.size());
+        for (uint32_t i{ 0 }; i < order.size(); ++i)
+          order[i] = i;
+        std::ranges::sort(order, [&](uint32_t lhs, uint32_t rhs)
+        {
+          return std::tuple{ bitsOf(lhs), lhs } < std::tuple{ bitsOf(rhs), rhs };
+        });
+
+        representative.resize(wedges.size());
+        seam.assign(wedges.size(), false);
+        for (size_t i{ 0 }; i < order.size();)
+        {
+          auto j{ i };
+          while (j < order.size() && bitsOf(order[j]) == bitsOf(order[i]))
+            representative[order[j++]] = order[i];
+
+          seam[order[i]] = j - i > 1;
+          i = j;
+        }
+
+        remap.resize(wedges.size());
+        for (uint32_t i{ 0 }; i < remap.size(); ++i)
+          remap[i] = i;
+
+        quadrics.assign(wedges.size(), Quadric{});
+        BuildTopology();
+        for (uint32_t t{ 0 }; t < triangles.size(); ++t)
+        {
+          auto const normal{ FaceNormal(triangles[t]) };
+          auto const area{ normal.Length() };
+          if (area == 0.0)
+            continue;
+
+          Vec3d const n{ normal.x / area, normal.y / area, normal.z / area };
+          auto const d{ -n.Dot(points[triangles[t][0]]) };
+          for (auto const corner : triangles[t])
+            quadrics[representative[corner]].AddPlane(n, d, area * 0.5);
+        }
+
+        // Constraint planes perpendicular to each open border edge
+        for (size_t i{ 0 }; i < edges.size(); ++i)
+        {
+          if (EdgeUseCount(i) != 1)
+            continue;
+
+          auto const& edge{ edges[i] };
+          auto const faceNormal{ FaceNormal(triangles[edge.triangle]) };
+          auto const along{ points[edge.b] - points[edge.a] };
+          auto const normal{ along.Cross(faceNormal) };
+          auto const length{ normal.Length() };
+          if (length == 0.0)
+            continue;
+
+          Vec3d const n{ normal.x / length, normal.y / length, normal.z / length };
+          auto const d{ -n.Dot(points[edge.a]) };
+          auto const weight{ along.Dot(along) * BORDER_WEIGHT };
+          quadrics[edge.a].AddPlane(n, d, weight);
+          quadrics[edge.b].AddPlane(n, d, weight);
+        }
+      }
+
+      /*************************************************************************
+       * Collapses edges in passes of independent cheapest collapses until the
+       * triangle count drops to each target in turn. Returns one level per
+       * target reached, plus a final coarser level if maxErrorSquared stopped
+       * simplification before the next target.
+       *************************************************************************/
+      std::vector<Level> Simplify(std::vector<size_t> const& targets, double maxErrorSquared)
+      {
+        std::vector<Level> levels;
+        double error{ 0.0 };
+        size_t lastCount{ triangles.size() };
+
+        for (auto const target : targets)
+        {
+          while (triangles.size() > target)
+          {
+            auto const collapsed{ CollapsePass(target, maxErrorSquared, error) };
+            if (collapsed == 0)
+              break;
+          }
+
+          if (triangles.size() >= lastCount)
+            break;
+
+          levels.push_back({ Emit(), std::sqrt(error) });
+          lastCount = triangles.size();
+
+          if (triangles.size() > target)
+            break;
+        }
+
+        return levels;
+      }
+
+    private:
+      std::vector<IndexType> wedges;
+      std::vector<Vec3d> points;
+      std::vector<uint32_t> representative;
+      std::vector<bool> seam;
+      std::vector<uint32_t> remap;
+      std::vector<Quadric> quadrics;
+      std::vector<Triangle> triangles;
+
+      // Per pass topology over representatives
+      std::vector<Edge> edges;
+      std::vector<uint32_t> edgeRunEnd;
+      std::vector<uint32_t> adjacencyOffsets;
+      std::vector<uint32_t> adjacency;
+      std::vector<bool> border;
+      std::vector<bool> locked;
+
+      Vec3d FaceNormal(Triangle const& triangle) const noexcept
+      {
+        auto const& a{ points[triangle[0]] };
+        return (points[triangle[1]] - a).Cross(points[triangle[2]] - a);
+      }
+
+      size_t EdgeUseCount(size_t i) const noexcept
+      {
+        auto begin{ i };
+        while (begin > 0 && edges[begin - 1].a == edges[i].a && edges[begin - 1].b == edges[i].b)
+          --begin;
+        return edgeRunEnd[i] - begin;
+      }
+
+      void BuildTopology()
+      {
+        auto const count{ wedges.size() };
+
+        edges.clear();
+        for (uint32_t t{ 0 }; t < triangles.size(); ++t)
+        {
+          for (auto corner{ 0 }; corner < 3; ++corner)
+          {
+            auto a{ representative[triangles[t][corner]] };
+            auto b{ representative[triangles[t][(corner + 1) % 3]] };
+            if (a > b)
+              std::swap(a, b);
+            edges.push_back({ a, b, t });
+          }
+        }
+        std::ranges::sort(edges);
+
+        edgeRunEnd.resize(edges.size());
+        for (size_t i{ edges.size() }; i-- > 0;)
+        {
+          auto const sameAsNext{ i + 1 < edges.size() && edges[i + 1].a == edges[i].a && edges[i + 1].b == edges[i].b };
+          edgeRunEnd[i] = sameAsNext ? edgeRunEnd[i + 1] : static_cast<uint32_t>(i + 1);
+        }
+
+        border.assign(count, false);
+        locked.assign(count, false);
+        for (auto const wedge : representative)
+          locked[wedge] = locked[wedge] || seam[wedge];
+
+        for (size_t i{ 0 }; i < edges.size(); i = edgeRunEnd[i])
+        {
+          auto const uses{ edgeRunEnd[i] - i };
+          auto const& edge{ edges[i] };
+          if (uses == 1)
+            border[edge.a] = border[edge.b] = true;
+          else if (uses > 2)
+            locked[edge.a] = locked[edge.b] = true;
+        }
+
+        adjacencyOffsets.assign(count + 1, 0);
+        for (auto const& triangle : triangles)
+          for (auto const corner : triangle)
+            ++adjacencyOffsets[representative[corner] + 1];
+
+        for (size_t i{ 1 }; i < adjacencyOffsets.size(); ++i)
+          adjacencyOffsets[i] += adjacencyOffsets[i - 1];
+
+        adjacency.resize(triangles.size() * 3);
+        std::vector<uint32_t> cursor{ adjacencyOffsets.begin(), adjacencyOffsets.end() - 1 };
+        for (uint32_t t{ 0 }; t < triangles.size(); ++t)
+          for (auto const corner : triangles[t])
+            adjacency[cursor[representative[corner]]++] = t;
+      }
+
+      std::span<uint32_t const> TrianglesOf(uint32_t rep) const noexcept
+      {
+        return { adjacency.data() + adjacencyOffsets[rep], adjacency.data() + adjacencyOffsets[rep + 1] };
+      }
+
+      bool CanCollapse(uint32_t from, bool borderEdge) const noexcept
+      {
+        return !locked[from] && (!border[from] || borderEdge);
+      }
+
+      // Wedge of to that replaces the wedge of from, or nothing if the
+      // triangles around the edge disagree on the attributes at to
+      std::optional<uint32_t> TargetWedge(uint32_t from, uint32_t to) const noexcept
+      {
+        if (!seam[to])
+          return to;
+
+        std::optional<uint32_t> wedge;
+        for (auto const t : TrianglesOf(from))
+        {
+          for (auto const corner : triangles[t])
+          {
+            if (representative[corner] != to)
+              continue;
+            if (wedge && *wedge != corner)
+              return std::nullopt;
+            wedge = corner;
+          }
+        }
+        return wedge;
+      }
+
+      bool FlipsTriangle(uint32_t from, uint32_t to) const noexcept
+      {
+        for (auto const t : TrianglesOf(from))
+        {
+          auto triangle{ triangles[t] };
+          if (std::ranges::any_of(triangle, [&](uint32_t corner) { return representative[corner] == to; }))
+            continue;
+
+          auto const before{ FaceNormal(triangle) };
+          for (auto& corner : triangle)
+            if (representative[corner] == from)
+              corner = to;
+          auto const after{ FaceNormal(triangle) };
+
+          if (before.Dot(after) <= MIN_NORMAL_COSINE * before.Length() * after.Length())
+            return true;
+        }
+        return false;
+      }
+
+      size_t CollapsePass(size_t target, double maxErrorSquared, double& error)
+      {
+        BuildTopology();
+
+        std::vector<Collapse> candidates;
+        for (size_t i{ 0 }; i < edges.size(); i = edgeRunEnd[i])
+        {
+          auto const& edge{ edges[i] };
+          auto const borderEdge{ edgeRunEnd[i] - i == 1 };
+          if (edgeRunEnd[i] - i > 2)
+            continue;
+
+          auto combined{ quadrics[edge.a] };
+          combined += quadrics[edge.b];
+
+          std::optional<Collapse> best;
+          if (CanCollapse(edge.a, borderEdge))
+            best = Collapse{ combined.Error(points[edge.b]), edge.a, edge.b };
+          if (CanCollapse(edge.b, borderEdge))
+          {
+            Collapse const reverse{ combined.Error(points[edge.a]), edge.b, edge.a };
+            if (!best || reverse < *best)
+              best = reverse;
+          }
+
+          if (best && best->cost <= maxErrorSquared)
+            candidates.push_back(*best);
+        }
+        std::ranges::sort(candidates);
+
+        // Interior collapses remove two triangles, so half the excess is enough
+        auto const budget{ std::max<size_t>(1, (triangles.size() - target + 1) / 2) };
+        std::vector<bool> touched(wedges.size(), false);
+        size_t collapsed{ 0 };
+
+        for (auto const& candidate : candidates)
+        {
+          if (collapsed >= budget)
+            break;
+
+          auto const [cost, from, to] { candidate };
+          if (touched[from] || touched[to])
+            continue;
+
+          // Neighbours of from must not move this pass for the flip test to hold
+          auto const neighbourMoved = std::ranges::any_of(TrianglesOf(from), [&](uint32_t t)
+          {
+            return std::ranges::any_of(triangles[t], [&](uint32_t corner) { return touched[representative[corner]]; });
+          });
+          if (neighbourMoved)
+            continue;
+
+          auto const wedge{ TargetWedge(from, to) };
+          if (!wedge || FlipsTriangle(from, to))
+            continue;
+
+          remap[from] = *wedge;
+          quadrics[to] += quadrics[from];
+          error = std::max(error, cost);
+          ++collapsed;
+
+          for (auto const t : TrianglesOf(from))
+            for (auto const corner : triangles[t])
+              touched[representative[corner]] = true;
+        }
+
+        if (collapsed == 0)
+          return 0;
+
+        std::erase_if(triangles, [this](Triangle& triangle)
+        {
+          for (auto& corner : triangle)
+            corner = remap[corner];
+
+          auto const a{ representative[triangle[0]] };
+          auto const b{ representative[triangle[1]] };
+          auto const c{ representative[triangle[2]] };
+          return a == b || b == c || a == c;
+        });
+
+        return collapsed;
+      }
+
+      std::vector<IndexType> Emit() const
+      {
+        std::vector<IndexType> indices;
+        indices.reserve(triangles.size() * 3);
+        for (auto const& triangle : triangles)
+          for (auto const corner : triangle)
+            indices.push_back(wedges[corner]);
+        return indices;
+      }
+    };
+  }
+
+  void MeshSimplifier::BuildLods(MeshData& mesh, std::vector<float> const& ratios, float maxError) noexcept
+  {
+    mesh.lods.clear();
+    mesh.lodSubMeshes.clear();
+    mesh.lodIndices.clear();
+
+    if (ratios.empty() || mesh.vertexPosition.empty())
+      return;
+
+    std::vector<float> sortedRatios;
+    std::ranges::copy_if(ratios, std::back_inserter(sortedRatios), [](float ratio) { return ratio > 0.f && ratio < 1.f; });
+    std::ranges::sort(sortedRatios, std::greater{});
+
+    SHVec3 min{ mesh.vertexPosition.front() }, max{ mesh.vertexPosition.front() };
+    for (auto const& p : mesh.vertexPosition)
+    {
+      min.x = std::min(min.x, p.x); min.y = std::min(min.y, p.y); min.z = std::min(min.z, p.z);
+      max.x = std::max(max.x, p.x); max.y = std::max(max.y, p.y); max.z = std::max(max.z, p.z);
+    }
+    auto const extent{ static_cast<double>(std::max({ max.x - min.x, max.y - min.y, max.z - min.z })) };
+    auto const errorLimit{ maxError * extent };
+
+    // Levels per submesh, a submesh short of levels repeats its coarsest
+    std::vector<std::vector<Level>> subMeshLevels;
+    size_t levelCount{ 0 };
+    for (auto const& subMesh : mesh.subMeshes)
+    {
+      std::span<IndexType const> const indices{
+        mesh.indices.data() + subMesh.indexOffset,
+        subMesh.indexCount - subMesh.indexCount % 3
+      };
+
+      std::vector<size_t> targets;
+      for (auto const ratio : sortedRatios)
+        targets.push_back(static_cast<size_t>(indices.size() / 3 * static_cast<double>(ratio)));
+
+      SubMeshSimplifier simplifier{ indices, mesh.vertexPosition };
+      subMeshLevels.push_back(simplifier.Simplify(targets, errorLimit * errorLimit));
+      levelCount = std::max(levelCount, subMeshLevels.back().size());
+    }
+
+    for (size_t l{ 0 }; l < levelCount; ++l)
+    {
+      MeshLod lod{ static_cast<uint32_t>(mesh.lodIndices.size()), 0, 0.f };
+
+      for (size_t s{ 0 }; s < mesh.subMeshes.size(); ++s)
+      {
+        auto const& levels{ subMeshLevels[s] };
+        IndexRange const range{ static_cast<uint32_t>(mesh.lodIndices.size()), 0 };
+
+        if (levels.empty())
+        {
+          auto const& subMesh{ mesh.subMeshes[s] };
+          auto const begin{ mesh.indices.begin() + subMesh.indexOffset };
+          mesh.lodIndices.insert(mesh.lodIndices.end(), begin, begin + subMesh.indexCount);
+        }
+        else
+        {
+          auto const& level{ levels[std::min(l, levels.size() - 1)] };
+          mesh.lodIndices.insert(mesh.lodIndices.end(), level.indices.begin(), level.indices.end());
+          lod.error = std::max(lod.error, static_cast<float>(level.error));
+        }
+
+        mesh.lodSubMeshes.push_back({ range.indexOffset, static_cast<uint32_t>(mesh.lodIndices.size()) - range.indexOffset });
+      }
+
+      lod.indexCount = static_cast<uint32_t>(mesh.lodIndices.size()) - lod.indexOffset;
+      mesh.lods.push_back(lod);
+    }
+  }
+}
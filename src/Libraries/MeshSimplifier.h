@@ -0,0 +1,34 @@
+/******************************************************************************
+ * \file    MeshSimplifier.h
+ * \author  Loh Xiao Qi
+ * \brief   Quadric error metric simplification, used to generate LOD index
+ *					buffers over the existing vertex streams
+ * 
+ * \copyright	Copyright (c) 2022 Digipen Institute of Technology. Reproduction
+ *						or disclosure of this file or its contents without the prior
+ *						written consent of Digipen Institute of Technology is prohibited
+ ******************************************************************************/
+#pragma once
+
+#include <vector>
+
+#include "Types/MeshAsset.h"
+
+namespace SH_COMP
+{
+	struct MeshSimplifier
+	{
+		/*************************************************************************
+		 * Fills mesh.lods with one level per ratio in ratios (fraction of the
+		 * full triangle count, descending). Edges are collapsed onto one of
+		 * their existing vertices, so every level shares the mesh vertex
+		 * streams. Vertices on attribute seams and non manifold edges stay
+		 * fixed, open borders only collapse along themselves.
+		 *
+		 * Simplification stops early once a collapse would exceed maxError,
+		 * given as a fraction of the largest mesh extent. Levels that could
+		 * not get any coarser are dropped.
+		 *************************************************************************/
+		static void BuildLods(MeshData& mesh, std::vector<float> const& ratios, float maxError) noexcept;
+	};
+}
@@ -9,20 +9,88 @@
  *			      written consent of Digipen Institute of Technology is prohibited.
  ******************************************************************************/
 #include "MeshWriter.h"
+#include "VertexQuantisation.h"
+#include "KeyQuantisation.h"
 #include <fstream>
 #include <iostream>
 #include <stack>
 #include <queue>
+#include <algorithm>
 
 namespace SH_COMP
 {
+  template <typename T>
+  void MeshWriter::WriteStream(FileReference file, std::vector<T> const& stream)
+  {
+    file.write(
+      reinterpret_cast<char const*>(stream.data()),
+      sizeof(T) * stream.size()
+    );
+  }
+
+  void MeshWriter::WriteIndices(FileReference file, std::vector<IndexType> const& indices, uint8_t indexSize)
+  {
+    if (indexSize == sizeof(uint16_t))
+    {
+      std::vector<uint16_t> narrowIndices(indices.size());
+      std::ranges::transform(
+        indices,
+        narrowIndices.begin(),
+        [](IndexType index) { return static_cast<uint16_t>(index); }
+      );
+      WriteStream(file, narrowIndices);
+    }
+    else
+    {
+      WriteStream(file, indices);
+    }
+  }
+
+  void MeshWriter::Align(FileReference file, size_t alignment)
+  {
+    static constexpr char ZEROES[MODEL_SECTION_ALIGNMENT]{};
+
+    auto const position{ static_cast<size_t>(file.tellp()) };
+    file.write(ZEROES, (alignment - position % alignment) % alignment);
+  }
+
+  std::streamoff MeshWriter::BeginSection(FileReference file, size_t alignment)
+  {
+    Align(file, alignment);
+    return file.tellp();
+  }
+
+  FileSection MeshWriter::EndSection(FileReference file, std::streamoff begin)
+  {
+    return {
+      static_cast<uint64_t>(begin),
+      static_cast<uint64_t>(static_cast<std::streamoff>(file.tellp()) - begin)
+    };
+  }
+
+  void MeshWriter::WriteSectionTable(FileReference file, SectionTable const& table)
+  {
+    file.write(
+      reinterpret_cast<char const*>(&table.model),
+      sizeof(ModelSections)
+    );
+
+    WriteStream(file, table.meshes);
+    WriteStream(file, table.anims);
+  }
+
   void MeshWriter::WriteMeshData(FileReference file, std::vector<MeshDataHeader> const& headers,
-	  std::vector<MeshData> const& meshes)
+	  std::vector<MeshData> const& meshes, std::vector<MeshSections>& sections)
   {
+    sections.resize(headers.size());
     for (auto i {0}; i < headers.size(); ++i)
     {
       auto const& header = headers[i];
       auto const& asset = meshes[i];
+      auto& section = sections[i];
+      section = {};
+
+      std::streamoff const bodyBegin{ BeginSection(file, MODEL_SECTION_ALIGNMENT) };
 
 	    auto const vertexVec3Byte{ sizeof(SHVec3) * header.vertexCount };
 	    auto const vertexVec2Byte{ sizeof(SHVec2) * header.vertexCount };
@@ -32,62 +100,152 @@ namespace SH_COMP
 	      header.charCount
 	    );
 
+      std::streamoff begin{ BeginSection(file, MODEL_STREAM_ALIGNMENT) };
+	    if (header.vertexEncoding & VERTEX_ENCODING_POSITION_UNORM16)
+	    {
+	      WriteStream(file, VertexQuantisation::EncodePositions(asset.vertexPosition, header.positionOffset, header.positionScale));
+	    }
+	    else
+	    {
+	      file.write(
+	        reinterpret_cast<char const*>(asset.vertexPosition.data()),
+	        vertexVec3Byte
+	      );
+	    }
+
+      Align(file, MODEL_STREAM_ALIGNMENT);
+	    if (header.vertexEncoding & VERTEX_ENCODING_NORMAL_OCT16)
+	    {
+	      WriteStream(file, VertexQuantisation::EncodeOctahedral(asset.vertexTangent));
+        Align(file, MODEL_STREAM_ALIGNMENT);
+	      WriteStream(file, VertexQuantisation::EncodeOctahedral(asset.vertexNormal));
+	    }
+	    else
+	    {
+	      file.write(
+	        reinterpret_cast<char const*>(asset.vertexTangent.data()),
+	        vertexVec3Byte
+	      );
+
+        Align(file, MODEL_STREAM_ALIGNMENT);
+	      file.write(
+	        reinterpret_cast<char const*>(asset.vertexNormal.data()),
+	        vertexVec3Byte
+	      );
+	    }
+
+      Align(file, MODEL_STREAM_ALIGNMENT);
+	    if (header.vertexEncoding & VERTEX_ENCODING_TEXCOORD_HALF)
+	    {
+	      WriteStream(file, VertexQuantisation::EncodeHalf(asset.texCoords));
+	    }
+	    else
+	    {
+	      file.write(
+	        reinterpret_cast<char const*>(asset.texCoords.data()),
+	        vertexVec2Byte
+	      );
+	    }
+
+      section.vertices = EndSection(file, begin);
+
+      begin = BeginSection(file, MODEL_STREAM_ALIGNMENT);
+	    WriteIndices(file, asset.indices, header.indexSize);
+      section.indices = EndSection(file, begin);
+
+      begin = BeginSection(file, MODEL_STREAM_ALIGNMENT);
 	    file.write(
-	      reinterpret_cast<char const*>(asset.vertexPosition.data()),
-	      vertexVec3Byte
-	    );
-
-	    file.write(
-	      reinterpret_cast<char const*>(asset.vertexTangent.data()),
-	      vertexVec3Byte
-	    );
-
-	    file.write(
-	      reinterpret_cast<char const*>(asset.vertexNormal.data()),
-	      vertexVec3Byte
+	      reinterpret_cast<char const*>(asset.subMeshes.data()),
+	      sizeof(SubMesh) * header.subMeshCount
 	    );
+      section.subMeshes = EndSection(file, begin);
 
-	    file.write(
-	      reinterpret_cast<char const*>(asset.texCoords.data()),
-	      vertexVec2Byte
-	    );
+      if (header.hasWeights)
+      {
+        begin = BeginSection(file, MODEL_STREAM_ALIGNMENT);
+        if (header.weightSize == sizeof(uint8_t))
+          WriteStream(file, VertexQuantisation::EncodeWeights<uint8_t>(asset.weights));
+        else if (header.weightSize == sizeof(uint16_t))
+          WriteStream(file, VertexQuantisation::EncodeWeights<uint16_t>(asset.weights));
+        else
+          file.write(
+            reinterpret_cast<char const*>(asset.weights.data()),
+            sizeof(SHVec4) * header.vertexCount
+          );
+
+        Align(file, MODEL_STREAM_ALIGNMENT);
+        if (header.jointSize == sizeof(uint8_t))
+          WriteStream(file, VertexQuantisation::EncodeJoints<uint8_t>(asset.joints));
+        else if (header.jointSize == sizeof(uint16_t))
+          WriteStream(file, VertexQuantisation::EncodeJoints<uint16_t>(asset.joints));
+        else
+          file.write(
+            reinterpret_cast<char const*>(asset.joints.data()),
+            sizeof(SHVec4i) * header.vertexCount
+          );
+        section.skinning = EndSection(file, begin);
+      }
 
-	    file.write(
-	      reinterpret_cast<char const*>(asset.indices.data()),
-	      sizeof(uint32_t) * header.indexCount
-	    );
+      if (header.meshletCount > 0)
+      {
+        begin = BeginSection(file, MODEL_STREAM_ALIGNMENT);
+        WriteStream(file, asset.meshlets);
+        Align(file, MODEL_STREAM_ALIGNMENT);
+        WriteStream(file, asset.meshletVertices);
+        Align(file, MODEL_STREAM_ALIGNMENT);
+        WriteStream(file, asset.meshletTriangles);
+        section.meshlets = EndSection(file, begin);
+      }
 
-      if (header.hasWeights)
+      if (header.lodCount > 0)
       {
-        file.write(
-          reinterpret_cast<char const*>(asset.weights.data()),
-          sizeof(SHVec4) * header.vertexCount
-        );
-        file.write(
-          reinterpret_cast<char const*>(asset.joints.data()),
-          sizeof(SHVec4i) * header.vertexCount
-        );
+        begin = BeginSection(file, MODEL_STREAM_ALIGNMENT);
+        WriteStream(file, asset.lods);
+        Align(file, MODEL_STREAM_ALIGNMENT);
+        WriteStream(file, asset.lodSubMeshes);
+        section.lods = EndSection(file, begin);
+
+        begin = BeginSection(file, MODEL_STREAM_ALIGNMENT);
+        WriteIndices(file, asset.lodIndices, header.indexSize);
+        section.lodIndices = EndSection(file, begin);
       }
+
+      section.body = EndSection(file, bodyBegin);
+    }
+  }
+
+  template <typename Key>
+  void MeshWriter::WriteKeyValues(FileReference file, std::vector<Key> const& keys)
+  {
+    for (auto const& key : keys)
+    {
+      file.write(
+        reinterpret_cast<char const*>(&key.value),
+        sizeof(key.value)
+      );
     }
   }
 
   void MeshWriter::WriteAnimData(
     FileReference file, 
     std::vector<AnimDataHeader> const& headers,
-	  std::vector<AnimData> const& anims
+	  std::vector<AnimData> const& anims,
+    std::vector<FileSection>& sections
   )
   {
-    
+    sections.resize(headers.size());
     for (auto i {0}; i < headers.size(); ++i)
     {
       auto const& header = headers[i];
       auto const& data = anims[i];
+      std::streamoff const begin{ BeginSection(file, MODEL_SECTION_ALIGNMENT) };
     
 	    file.write(
 	      data.name.data(),
 	      header.charCount
 	    );
 
+      Align(file, MODEL_STREAM_ALIGNMENT);
 	    file.write(
 	      reinterpret_cast<char const*>(&data.duration),
 	      sizeof(double)
@@ -98,36 +256,61 @@ namespace SH_COMP
 	      sizeof(double)
 	    );
 
-      for (auto const& node : data.nodes)
+      Align(file, MODEL_STREAM_ALIGNMENT);
+      WriteStream(file, data.timelines);
+
+      Align(file, MODEL_STREAM_ALIGNMENT);
+      WriteStream(file, data.times);
+
+      Align(file, MODEL_STREAM_ALIGNMENT);
+      WriteStream(file, data.nodeHeaders);
+
+      bool const quantised{ (header.keyEncoding & KEY_ENCODING_QUANTISED) != 0 };
+      if (quantised)
       {
-        WriteAnimNode(file, node);
+        Align(file, MODEL_STREAM_ALIGNMENT);
+        WriteStream(file, data.quantisedNodes);
       }
-    }
-  }
 
-  void MeshWriter::WriteAnimNode(FileReference file, AnimNode const& node)
-  {
-    file.write(
-      reinterpret_cast<char const*>(&node.interpolation),
-      sizeof(AnimationInterpolation)
-    );
+      // Value streams follow node order, matching the offsets in the node headers
+      Align(file, MODEL_STREAM_ALIGNMENT);
+      for (size_t j{ 0 }; j < data.nodes.size(); ++j)
+      {
+        if (data.nodeHeaders[j].position.timeline == NO_TIMELINE)
+          continue;
 
-    uint32_t const keySize = node.positionKeys.size();
+        if (quantised)
+          WriteStream(file, KeyQuantisation::EncodePositions(data.nodes[j].positionKeys, data.quantisedNodes[j]));
+        else
+          WriteKeyValues(file, data.nodes[j].positionKeys);
+      }
 
-    file.write(
-      reinterpret_cast<char const*>(node.positionKeys.data()),
-      sizeof(PositionKey) * keySize
-    );
+      Align(file, MODEL_STREAM_ALIGNMENT);
+      for (size_t j{ 0 }; j < data.nodes.size(); ++j)
+      {
+        if (data.nodeHeaders[j].rotation.timeline == NO_TIMELINE)
+          continue;
 
-    file.write(
-      reinterpret_cast<char const*>(node.rotationKeys.data()),
-      sizeof(RotationKey) * keySize
-    );
+        if (quantised)
+          WriteStream(file, KeyQuantisation::EncodeRotations(data.nodes[j].rotationKeys));
+        else
+          WriteKeyValues(file, data.nodes[j].rotationKeys);
+      }
 
-    file.write(
-      reinterpret_cast<char const*>(node.scaleKeys.data()),
-      sizeof(ScaleKey) * keySize
-    );
+      Align(file, MODEL_STREAM_ALIGNMENT);
+      for (size_t j{ 0 }; j < data.nodes.size(); ++j)
+      {
+        if (data.nodeHeaders[j].scale.timeline == NO_TIMELINE)
+          continue;
+
+        if (quantised)
+          WriteStream(file, KeyQuantisation::EncodeScales(data.nodes[j].scaleKeys, data.quantisedNodes[j]));
+        else
+          WriteKeyValues(file, data.nodes[j].scaleKeys);
+      }
+
+      sections[i] = EndSection(file, begin);
+    }
   }
 
   void MeshWriter::WriteRig(FileReference file, RigData const& data)
@@ -243,13 +426,9 @@ namespace SH_COMP
     }
   }
 
-  void MeshWriter::WriteHeaders(FileReference file, ModelConstRef asset)
+  void MeshWriter::WriteHeaders(FileReference file, ModelConstRef asset, SectionTable& table)
   {
-    file.write(
-      reinterpret_cast<char const*>(&asset.header),
-      sizeof(asset.header)
-    );
-
+    std::streamoff begin{ BeginSection(file, MODEL_SECTION_ALIGNMENT) };
     if (asset.header.meshCount > 0)
     {
 	    file.write(
@@ -257,7 +436,9 @@ namespace SH_COMP
 	      sizeof(MeshDataHeader) * asset.header.meshCount
 	    );
     }
+    table.model.meshHeaders = EndSection(file, begin);
 
+    begin = BeginSection(file, MODEL_STREAM_ALIGNMENT);
     if (asset.header.animCount > 0)
     {
 	    file.write(
@@ -265,34 +446,72 @@ namespace SH_COMP
 	      sizeof(AnimDataHeader) * asset.header.animCount
 	    );
     }
+    table.model.animHeaders = EndSection(file, begin);
   }
 
-  void MeshWriter::WriteData(FileReference file, ModelConstRef asset)
+  void MeshWriter::WriteData(FileReference file, ModelConstRef asset, SectionTable& table)
   {
-    WriteMeshData(file, asset.meshHeaders, asset.meshes);
-    WriteAnimData(file, asset.animHeaders, asset.anims);
+    std::streamoff begin{ BeginSection(file, MODEL_SECTION_ALIGNMENT) };
+    WriteMeshData(file, asset.meshHeaders, asset.meshes, table.meshes);
+    table.model.meshData = EndSection(file, begin);
+
+    begin = BeginSection(file, MODEL_SECTION_ALIGNMENT);
+    WriteAnimData(file, asset.animHeaders, asset.anims, table.anims);
+    table.model.animData = EndSection(file, begin);
 
+    begin = BeginSection(file, MODEL_SECTION_ALIGNMENT);
     if (!asset.rig.nodes.empty())
     {
 			WriteRig(file, asset.rig);
     }
+    table.model.rig = EndSection(file, begin);
   }
 
-  void MeshWriter::CompileMeshBinary(AssetPath path, ModelAsset const& asset) noexcept
+  AssetPath MeshWriter::GetOutputPath(AssetPath path) noexcept
   {
     std::string newPath{ path.string().substr(0, path.string().find_last_of('.')) };
     newPath += MODEL_EXTENSION;
+    return newPath;
+  }
+
+  bool MeshWriter::CompileMeshBinary(AssetPath path, ModelAsset const& asset, std::ostream& log) noexcept
+  {
+    auto const newPath{ GetOutputPath(path) };
 
     std::ofstream file{ newPath, std::ios::out | std::ios::binary | std::ios::trunc };
     if (!file.is_open())
     {
-      std::cout << "Unable to open file for write: " << newPath << std::endl;
-      return;
+      log << "Unable to open file for write: " << newPath << std::endl;
+      return false;
     }
 
-    WriteHeaders(file, asset);
-    WriteData(file, asset);
+    file.write(
+      reinterpret_cast<char const*>(&asset.header),
+      sizeof(asset.header)
+    );
+
+    // Reserved now and rewritten once every section offset is known
+    SectionTable table{
+      .model = {},
+      .meshes = std::vector<MeshSections>(asset.header.meshCount),
+      .anims = std::vector<FileSection>(asset.header.animCount)
+    };
+    std::streamoff const tableOffset{ file.tellp() };
+    WriteSectionTable(file, table);
+
+    WriteHeaders(file, asset, table);
+    WriteData(file, asset, table);
+
+    file.seekp(tableOffset);
+    WriteSectionTable(file, table);
 
     file.close();
+    if (file.fail())
+    {
+      log << "Failed to write file: " << newPath << std::endl;
+      return false;
+    }
+
+    return true;
   }
 }
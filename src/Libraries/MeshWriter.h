@@ -10,6 +10,8 @@
  ******************************************************************************/
 #pragma once
 
+#include <ostream>
+
 #include "AssetMacros.h"
 #include "Types/ModelAsset.h"
 
@@ -20,18 +22,44 @@ namespace SH_COMP
     using FileReference = std::ofstream&;
     using ModelConstRef = ModelAsset const&;
 
-    static void WriteMeshData(FileReference file, std::vector<MeshDataHeader> const& headers, std::vector<MeshData> const& meshes);
-    static void WriteAnimData(FileReference file, std::vector<AnimDataHeader> const& headers, std::vector<AnimData> const& anims);
-    static void WriteAnimNode(FileReference file, AnimNode const& node);
+    // Every section table of one file, see ModelSections
+    struct SectionTable
+    {
+      ModelSections model;
+      std::vector<MeshSections> meshes;
+      std::vector<FileSection> anims;
+    };
+
+    // Pads with zeroes up to the next multiple of alignment, at most MODEL_SECTION_ALIGNMENT
+    static void Align(FileReference file, size_t alignment);
+    // Aligns then returns the write position
+    static std::streamoff BeginSection(FileReference file, size_t alignment);
+    // Range from begin to the current write position
+    static FileSection EndSection(FileReference file, std::streamoff begin);
+    static void WriteSectionTable(FileReference file, SectionTable const& table);
+
+    template <typename T>
+    static void WriteStream(FileReference file, std::vector<T> const& stream);
+
+    // Narrowed to 16 bits when indexSize is 2
+    static void WriteIndices(FileReference file, std::vector<IndexType> const& indices, uint8_t indexSize);
+
+    static void WriteMeshData(FileReference file, std::vector<MeshDataHeader> const& headers, std::vector<MeshData> const& meshes, std::vector<MeshSections>& sections);
+    static void WriteAnimData(FileReference file, std::vector<AnimDataHeader> const& headers, std::vector<AnimData> const& anims, std::vector<FileSection>& sections);
+
+    // Values only, the key times are written once per timeline
+    template <typename Key>
+    static void WriteKeyValues(FileReference file, std::vector<Key> const& keys);
 
     static void WriteRig(FileReference file, RigData const& data);
     static void WriteRigHeader(FileReference file, RigDataHeader const& header);
     static void WriteRigNodeData(FileReference file, RigData const& rig);
     static void WriteRigStructure(FileReference file, RigData const& rig);
 
-    static void WriteHeaders(FileReference file, ModelConstRef asset);
-    static void WriteData(FileReference file, ModelConstRef asset);
+    static void WriteHeaders(FileReference file, ModelConstRef asset, SectionTable& table);
+    static void WriteData(FileReference file, ModelConstRef asset, SectionTable& table);
 
-		static void CompileMeshBinary(AssetPath path, ModelConstRef asset) noexcept;
+		static AssetPath GetOutputPath(AssetPath path) noexcept;
+		static bool CompileMeshBinary(AssetPath path, ModelConstRef asset, std::ostream& log) noexcept;
 	};
 }
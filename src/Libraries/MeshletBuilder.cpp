@@ -0,0 +1,249 @@
+/******************************************************************************
+ * \file    MeshletBuilder.cpp
+ * \author  Loh Xiao Qi
+ * \brief   Splits mesh index buffers into meshlets with culling bounds
+ * 
+ * \copyright	Copyright (c) 2022 Digipen Institute of Technology. Reproduction
+ *						or disclosure of this file or its contents without the prior
+ *						written consent of Digipen Institute of Technology is prohibited
+ ******************************************************************************/
+#include "MeshletBuilder.h"
+#include "BoundingVolumes.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <span>
+#include <thread>
+
+namespace SH_COMP
+{
+  namespace
+  {
+    // Large submeshes are cut into independent tasks of this many triangles so
+    // one dense mesh still spreads across threads. Meshlets at a cut may be
+    // less than full, which costs at most one meshlet per cut.
+    constexpr uint32_t TRIANGLES_PER_TASK{ 1u << 16 };
+
+    constexpr uint16_t NOT_IN_MESHLET{ 0xFFFF };
+
+    struct MeshletTask
+    {
+      size_t mesh;
+      size_t subMesh;
+      uint32_t indexBegin;
+      uint32_t indexEnd;
+    };
+
+    // Output of one task, offsets are relative to the batch until merged
+    struct MeshletBatch
+    {
+      std::vector<Meshlet> meshlets;
+      std::vector<uint32_t> vertices;
+      std::vector<uint8_t> triangles;
+    };
+
+    SHVec3 TriangleNormal(SHVec3 const& a, SHVec3 const& b, SHVec3 const& c, float& length) noexcept
+    {
+      auto const ux{ b.x - a.x }, uy{ b.y - a.y }, uz{ b.z - a.z };
+      auto const vx{ c.x - a.x }, vy{ c.y - a.y }, vz{ c.z - a.z };
+
+      SHVec3 normal;
+      normal.x = uy * vz - uz * vy;
+      normal.y = uz * vx - ux * vz;
+      normal.z = ux * vy - uy * vx;
+
+      length = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+      if (length > 0.f)
+      {
+        normal.x /= length;
+        normal.y /= length;
+        normal.z /= length;
+      }
+      return normal;
+    }
+
+    void ComputeBounds(Meshlet& meshlet, MeshData const& mesh, MeshletBatch const& batch) noexcept
+    {
+      std::span<uint32_t const> const vertices{ batch.vertices.data() + meshlet.vertexOffset, meshlet.vertexCount };
+      auto const sphere{ BoundingVolumes::ComputeSphere(mesh.vertexPosition, vertices) };
+      meshlet.center[0] = sphere.center.x;
+      meshlet.center[1] = sphere.center.y;
+      meshlet.center[2] = sphere.center.z;
+      meshlet.radius = sphere.radius;
+
+      // Normal cone over the face normals, axis is their normalised average
+      std::vector<SHVec3> normals;
+      normals.reserve(meshlet.triangleCount);
+      float axis[3]{ 0.f, 0.f, 0.f };
+      for (uint32_t i{ 0 }; i < meshlet.triangleCount; ++i)
+      {
+        auto const* triangle{ batch.triangles.data() + meshlet.triangleOffset + i * 3 };
+        float area;
+        auto const normal{ TriangleNormal(
+          mesh.vertexPosition[vertices[triangle[0]]],
+          mesh.vertexPosition[vertices[triangle[1]]],
+          mesh.vertexPosition[vertices[triangle[2]]],
+          area
+        ) };
+
+        // Degenerate triangles are invisible and do not widen the cone
+        if (area == 0.f)
+          continue;
+
+        normals.push_back(normal);
+        axis[0] += normal.x;
+        axis[1] += normal.y;
+        axis[2] += normal.z;
+      }
+
+      std::fill_n(meshlet.coneAxis, 3, 0.f);
+      meshlet.coneCutoff = 1.f;
+
+      auto const axisLength{ std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]) };
+      if (normals.empty() || axisLength == 0.f)
+        return;
+
+      for (auto& component : axis)
+        component /= axisLength;
+
+      auto minDot{ 1.f };
+      for (auto const& normal : normals)
+        minDot = std::min(minDot, normal.x * axis[0] + normal.y * axis[1] + normal.z * axis[2]);
+
+      std::copy_n(axis, 3, meshlet.coneAxis);
+
+      // Spread of 90 degrees or more faces the eye from every side, the
+      // cutoff of 1 can never pass the culling test
+      if (minDot > 0.f)
+        meshlet.coneCutoff = std::sqrt(1.f - minDot * minDot);
+    }
+
+    // localIndex is per thread scratch, every entry is NOT_IN_MESHLET between calls
+    void BuildRange(MeshData const& mesh, uint32_t indexBegin, uint32_t indexEnd, uint32_t maxVertices, uint32_t maxTriangles, MeshletBatch& batch, std::vector<uint16_t>& localIndex)
+    {
+      if (localIndex.size() < mesh.vertexPosition.size())
+        localIndex.resize(mesh.vertexPosition.size(), NOT_IN_MESHLET);
+
+      Meshlet current{};
+
+      auto const flush = [&]()
+      {
+        if (current.triangleCount == 0)
+          return;
+
+        for (uint32_t i{ 0 }; i < current.vertexCount; ++i)
+          localIndex[batch.vertices[current.vertexOffset + i]] = NOT_IN_MESHLET;
+
+        ComputeBounds(current, mesh, batch);
+        batch.meshlets.push_back(current);
+
+        current = {};
+        current.vertexOffset = static_cast<uint32_t>(batch.vertices.size());
+        current.triangleOffset = static_cast<uint32_t>(batch.triangles.size());
+      };
+
+      for (auto i{ indexBegin }; i + 2 < indexEnd; i += 3)
+      {
+        IndexType const triangle[3]{ mesh.indices[i], mesh.indices[i + 1], mesh.indices[i + 2] };
+
+        uint32_t newVertices{ 0 };
+        for (auto const vertex : triangle)
+          newVertices += localIndex[vertex] == NOT_IN_MESHLET;
+
+        if (current.vertexCount + newVertices > maxVertices || current.triangleCount + 1 > maxTriangles)
+          flush();
+
+        for (auto const vertex : triangle)
+        {
+          if (localIndex[vertex] == NOT_IN_MESHLET)
+          {
+            localIndex[vertex] = static_cast<uint16_t>(current.vertexCount++);
+            batch.vertices.push_back(vertex);
+          }
+          batch.triangles.push_back(static_cast<uint8_t>(localIndex[vertex]));
+        }
+        ++current.triangleCount;
+      }
+
+      flush();
+    }
+  }
+
+  void MeshletBuilder::Build(std::vector<MeshData>& meshes, uint32_t maxVertices, uint32_t maxTriangles, unsigned threadCount) noexcept
+  {
+    maxVertices = std::clamp(maxVertices, 3u, MAX_VERTICES);
+    maxTriangles = std::clamp(maxTriangles, 1u, MAX_TRIANGLES);
+
+    std::vector<MeshletTask> tasks;
+    for (size_t m{ 0 }; m < meshes.size(); ++m)
+    {
+      auto const& subMeshes{ meshes[m].subMeshes };
+      for (size_t s{ 0 }; s < subMeshes.size(); ++s)
+      {
+        auto const begin{ subMeshes[s].indexOffset };
+        auto const end{ begin + subMeshes[s].indexCount };
+        for (auto i{ begin }; i < end; i += TRIANGLES_PER_TASK * 3)
+          tasks.push_back({ m, s, i, std::min(end, i + TRIANGLES_PER_TASK * 3) });
+      }
+    }
+
+    std::vector<MeshletBatch> batches(tasks.size());
+    std::atomic<size_t> next{ 0 };
+    auto const worker = [&]()
+    {
+      std::vector<uint16_t> localIndex;
+      for (auto i{ next++ }; i < tasks.size(); i = next++)
+      {
+        auto const& task{ tasks[i] };
+        BuildRange(meshes[task.mesh], task.indexBegin, task.indexEnd, maxVertices, maxTriangles, batches[i], localIndex);
+      }
+    };
+
+    threadCount = std::max(1u, std::min(threadCount, static_cast<unsigned>(tasks.size())));
+    {
+      std::vector<std::jthread> workers;
+      workers.reserve(threadCount - 1);
+      for (auto i{ 1u }; i < threadCount; ++i)
+        workers.emplace_back(worker);
+
+      worker();
+    }
+
+    // Merge batches in task order, which is mesh then submesh then index order
+    for (auto& mesh : meshes)
+    {
+      mesh.meshlets.clear();
+      mesh.meshletVertices.clear();
+      mesh.meshletTriangles.clear();
+      for (auto& subMesh : mesh.subMeshes)
+      {
+        subMesh.meshletOffset = 0;
+        subMesh.meshletCount = 0;
+      }
+    }
+
+    for (size_t i{ 0 }; i < tasks.size(); ++i)
+    {
+      auto& mesh{ meshes[tasks[i].mesh] };
+      auto& subMesh{ mesh.subMeshes[tasks[i].subMesh] };
+      auto const& batch{ batches[i] };
+
+      if (subMesh.meshletCount == 0)
+        subMesh.meshletOffset = static_cast<uint32_t>(mesh.meshlets.size());
+      subMesh.meshletCount += static_cast<uint32_t>(batch.meshlets.size());
+
+      auto const vertexBase{ static_cast<uint32_t>(mesh.meshletVertices.size()) };
+      auto const triangleBase{ static_cast<uint32_t>(mesh.meshletTriangles.size()) };
+      for (auto meshlet : batch.meshlets)
+      {
+        meshlet.vertexOffset += vertexBase;
+        meshlet.triangleOffset += triangleBase;
+        mesh.meshlets.push_back(meshlet);
+      }
+
+      mesh.meshletVertices.insert(mesh.meshletVertices.end(), batch.vertices.begin(), batch.vertices.end());
+      mesh.meshletTriangles.insert(mesh.meshletTriangles.end(), batch.triangles.begin(), batch.triangles.end());
+    }
+  }
+}
@@ -0,0 +1,33 @@
+/******************************************************************************
+ * \file    MeshletBuilder.h
+ * \author  Loh Xiao Qi
+ * \brief   Splits mesh index buffers into meshlets with culling bounds, for
+ *					mesh shader and GPU driven culling pipelines
+ * 
+ * \copyright	Copyright (c) 2022 Digipen Institute of Technology. Reproduction
+ *						or disclosure of this file or its contents without the prior
+ *						written consent of Digipen Institute of Technology is prohibited
+ ******************************************************************************/
+#pragma once
+
+#include "Types/MeshAsset.h"
+
+namespace SH_COMP
+{
+	struct MeshletBuilder
+	{
+		// Local triangle indices are a byte each
+		static constexpr uint32_t MAX_VERTICES{ 256 };
+		static constexpr uint32_t MAX_TRIANGLES{ 512 };
+
+		/*************************************************************************
+		 * Greedily packs triangles, in index buffer order, into meshlets of at
+		 * most maxVertices unique vertices and maxTriangles triangles. Meshlets
+		 * never span submeshes. Work is split across threads over every mesh,
+		 * and within large submeshes, while output stays deterministic.
+		 * Best run after vertex cache optimisation, which keeps neighbouring
+		 * triangles close together in the index buffer.
+		 *************************************************************************/
+		static void Build(std::vector<MeshData>& meshes, uint32_t maxVertices, uint32_t maxTriangles, unsigned threadCount) noexcept;
+	};
+}
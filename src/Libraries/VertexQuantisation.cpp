@@ -0,0 +1,168 @@
+/******************************************************************************
+ * \file    VertexQuantisation.cpp
+ * \author  Loh Xiao Qi
+ * \brief   Encoders for the compact vertex stream formats in MeshAsset.h
+ * 
+ * \copyright	Copyright (c) 2022 Digipen Institute of Technology. Reproduction
+ *						or disclosure of this file or its contents without the prior
+ *						written consent of Digipen Institute of Technology is prohibited
+ ******************************************************************************/
+#include "VertexQuantisation.h"
+#include "VectorMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace SH_COMP
+{
+  namespace
+  {
+    constexpr float SNORM16_MAX{ 32767.f };
+
+    int16_t ToSnorm16(float value) noexcept
+    {
+      return static_cast<int16_t>(std::lround(std::clamp(value, -1.f, 1.f) * SNORM16_MAX));
+    }
+
+    float SignNotZero(float value) noexcept
+    {
+      return value >= 0.f ? 1.f : -1.f;
+    }
+  }
+
+  void VertexQuantisation::ComputePositionRange(std::vector<SHVec3> const& positions, SHVec3& offset, SHVec3& scale) noexcept
+  {
+    if (positions.empty())
+    {
+      offset = SHVec3{};
+      scale = SHVec3{};
+      return;
+    }
+
+    auto min{ positions[0] }, max{ positions[0] };
+    for (auto const& position : positions)
+    {
+      min.x = std::min(min.x, position.x);
+      min.y = std::min(min.y, position.y);
+      min.z = std::min(min.z, position.z);
+      max.x = std::max(max.x, position.x);
+      max.y = std::max(max.y, position.y);
+      max.z = std::max(max.z, position.z);
+    }
+
+    offset = min;
+    scale.x = (max.x - min.x) / UNORM16_MAX;
+    scale.y = (max.y - min.y) / UNORM16_MAX;
+    scale.z = (max.z - min.z) / UNORM16_MAX;
+  }
+
+  std::vector<QuantisedPosition> VertexQuantisation::EncodePositions(
+    std::vector<SHVec3> const& positions, SHVec3 const& offset, SHVec3 const& scale) noexcept
+  {
+    std::vector<QuantisedPosition> result(positions.size());
+    std::ranges::transform(
+      positions,
+      result.begin(),
+      [&offset, &scale](SHVec3 const& position)->QuantisedPosition
+      {
+        return {
+          ToUnorm16(position.x, offset.x, scale.x),
+          ToUnorm16(position.y, offset.y, scale.y),
+          ToUnorm16(position.z, offset.z, scale.z),
+          0
+        };
+      }
+    );
+
+    return result;
+  }
+
+  std::vector<OctahedralVector> VertexQuantisation::EncodeOctahedral(std::vector<SHVec3> const& vectors) noexcept
+  {
+    std::vector<OctahedralVector> result(vectors.size());
+    std::ranges::transform(
+      vectors,
+      result.begin(),
+      [](SHVec3 const& vector)->OctahedralVector
+      {
+        auto const length{ std::abs(vector.x) + std::abs(vector.y) + std::abs(vector.z) };
+        if (length == 0.f)
+          return { 0, 0 };
+
+        auto x{ vector.x / length };
+        auto y{ vector.y / length };
+
+        // Fold the lower hemisphere over the diagonals
+        if (vector.z < 0.f)
+        {
+          auto const foldedX{ (1.f - std::abs(y)) * SignNotZero(x) };
+          auto const foldedY{ (1.f - std::abs(x)) * SignNotZero(y) };
+          x = foldedX;
+          y = foldedY;
+        }
+
+        return { ToSnorm16(x), ToSnorm16(y) };
+      }
+    );
+
+    return result;
+  }
+
+  std::vector<HalfVec2> VertexQuantisation::EncodeHalf(std::vector<SHVec2> const& values) noexcept
+  {
+    std::vector<HalfVec2> result(values.size());
+    std::ranges::transform(
+      values,
+      result.begin(),
+      [](SHVec2 const& value)->HalfVec2
+      {
+        return { FloatToHalf(value.x), FloatToHalf(value.y) };
+      }
+    );
+
+    return result;
+  }
+
+  uint16_t VertexQuantisation::FloatToHalf(float value) noexcept
+  {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t const sign{ (bits >> 16) & 0x8000u };
+    uint32_t const magnitude{ bits & 0x7FFFFFFFu };
+
+    // NaN stays NaN, overflow and infinity become infinity
+    if (magnitude > 0x7F800000u)
+      return static_cast<uint16_t>(sign | 0x7E00u);
+    if (magnitude >= 0x477FF000u)
+      return static_cast<uint16_t>(sign | 0x7C00u);
+
+    // Subnormal half, round to nearest even at the shifted position
+    if (magnitude < 0x38800000u)
+    {
+      if (magnitude < 0x33000000u)
+        return static_cast<uint16_t>(sign);
+
+      uint32_t const exponent{ magnitude >> 23 };
+      uint32_t const mantissa{ (magnitude & 0x007FFFFFu) | 0x00800000u };
+      uint32_t const shift{ 126u - exponent };
+      uint32_t half{ mantissa >> shift };
+      uint32_t const remainder{ mantissa & ((1u << shift) - 1u) };
+      uint32_t const halfway{ 1u << (shift - 1u) };
+      if (remainder > halfway || (remainder == halfway && (half & 1u)))
+        ++half;
+
+      return static_cast<uint16_t>(sign | half);
+    }
+
+    // Normal half, rebias the exponent and round the mantissa to 10 bits
+    uint32_t half{ (magnitude - 0x38000000u) >> 13 };
+    uint32_t const remainder{ magnitude & 0x1FFFu };
+    if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u)))
+      ++half;
+
+    return static_cast<uint16_t>(sign | half);
+  }
+}
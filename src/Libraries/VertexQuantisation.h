@@ -0,0 +1,101 @@
+/******************************************************************************
+ * \file    VertexQuantisation.h
+ * \author  Loh Xiao Qi
+ * \brief   Encoders for the compact vertex stream formats in MeshAsset.h
+ * 
+ * \copyright	Copyright (c) 2022 Digipen Institute of Technology. Reproduction
+ *						or disclosure of this file or its contents without the prior
+ *						written consent of Digipen Institute of Technology is prohibited
+ ******************************************************************************/
+#pragma once
+
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "Types/MeshAsset.h"
+
+namespace SH_COMP
+{
+	struct VertexQuantisation
+	{
+		// Offset and scale map the position bounds onto the full unorm16 range
+		static void ComputePositionRange(std::vector<SHVec3> const& positions, SHVec3& offset, SHVec3& scale) noexcept;
+
+		static std::vector<QuantisedPosition> EncodePositions(std::vector<SHVec3> const& positions, SHVec3 const& offset, SHVec3 const& scale) noexcept;
+		static std::vector<OctahedralVector> EncodeOctahedral(std::vector<SHVec3> const& vectors) noexcept;
+		static std::vector<HalfVec2> EncodeHalf(std::vector<SHVec2> const& values) noexcept;
+
+		// Renormalised unorm weights whose four components sum to exactly the
+		// unorm maximum. T is uint8_t or uint16_t.
+		template <typename T>
+		static std::vector<T> EncodeWeights(std::vector<SHVec4> const& weights) noexcept;
+
+		// Narrows each joint index to T, which every index must fit in
+		template <typename T>
+		static std::vector<T> EncodeJoints(std::vector<SHVec4i> const& joints) noexcept;
+
+		static uint16_t FloatToHalf(float value) noexcept;
+	};
+
+	template <typename T>
+	std::vector<T> VertexQuantisation::EncodeWeights(std::vector<SHVec4> const& weights) noexcept
+	{
+		constexpr auto UNORM_MAX{ std::numeric_limits<T>::max() };
+
+		std::vector<T> result(weights.size() * 4);
+		for (size_t i{ 0 }; i < weights.size(); ++i)
+		{
+			std::array<float, 4> const values{
+				std::max(weights[i].x, 0.f), std::max(weights[i].y, 0.f),
+				std::max(weights[i].z, 0.f), std::max(weights[i].w, 0.f)
+			};
+
+			auto const sum{ values[0] + values[1] + values[2] + values[3] };
+			auto const out{ result.data() + i * 4 };
+			if (sum <= 0.f)
+			{
+				out[0] = UNORM_MAX;
+				continue;
+			}
+
+			// Largest remainder rounding keeps the total at exactly UNORM_MAX
+			std::array<float, 4> remainders;
+			uint32_t total{ 0 };
+			for (auto j{ 0 }; j < 4; ++j)
+			{
+				auto const scaled{ values[j] / sum * UNORM_MAX };
+				auto const whole{ std::floor(scaled) };
+				out[j] = static_cast<T>(whole);
+				remainders[j] = scaled - whole;
+				total += out[j];
+			}
+
+			for (; total < UNORM_MAX; ++total)
+			{
+				auto const largest{ std::ranges::max_element(remainders) - remainders.begin() };
+				++out[largest];
+				remainders[largest] = -1.f;
+			}
+		}
+
+		return result;
+	}
+
+	template <typename T>
+	std::vector<T> VertexQuantisation::EncodeJoints(std::vector<SHVec4i> const& joints) noexcept
+	{
+		std::vector<T> result(joints.size() * 4);
+		for (size_t i{ 0 }; i < joints.size(); ++i)
+		{
+			result[i * 4 + 0] = static_cast<T>(joints[i].x);
+			result[i * 4 + 1] = static_cast<T>(joints[i].y);
+			result[i * 4 + 2] = static_cast<T>(joints[i].z);
+			result[i * 4 + 3] = static_cast<T>(joints[i].w);
+		}
+
+		return result;
+	}
+}
@@ -25,7 +25,7 @@ namespace SH_COMP
 		{}
 
 		SHVec3(float inx, float iny, float inz)
-			:x{ iny }, y{ iny }, z{ inz }
+			:x{ inx }, y{ iny }, z{ inz }
 		{}
 
 		float x, y, z;
@@ -10,10 +10,12 @@
  *****************************************************************************/
 #pragma once
 
-#include "PseudoMath.h"
+#include <cstdint>
 #include <vector>
 #include <string>
 
+#include "PseudoMath.h"
+
 namespace SH_COMP
 {
 	enum class AnimationInterpolation : uint8_t
@@ -46,17 +48,114 @@ namespace SH_COMP
 		SHVec3 value;
 	};
 
+	using KeyEncodingFlag = uint8_t;
+
+	// Clip wide key encodings. Without a flag the value streams hold SHVec3
+	// positions and scales and SHVec4 rotations.
+	constexpr KeyEncodingFlag KEY_ENCODING_QUANTISED = 0b0001;
+	// Key i of every timeline is at tick i, so the keys around a time t are
+	// floor(t) and floor(t) + 1 without a search
+	constexpr KeyEncodingFlag KEY_ENCODING_UNIFORM = 0b0010;
+
+	/***************************************************************************
+	 * A clip is stored as structure of arrays. Every channel's key times are
+	 * a range of the clip's time array, shared by all channels with the same
+	 * times, and its values are a range of the clip's position, rotation or
+	 * scale stream.
+	 ***************************************************************************/
+	struct KeyTimeline
+	{
+		uint32_t offset;
+		uint32_t count;
+	};
+
+	// Timeline of channels with no keys in the file
+	constexpr uint32_t NO_TIMELINE{ 0xFFFFFFFF };
+
+	struct AnimChannel
+	{
+		uint32_t timeline;
+		// First value in the clip's stream for this channel
+		uint32_t offset;
+	};
+
+	struct AnimNodeHeader
+	{
+		AnimChannel position;
+		AnimChannel rotation;
+		AnimChannel scale;
+		AnimationInterpolation interpolation;
+		uint8_t padding[3];
+	};
+
+	static_assert(sizeof(AnimNodeHeader) == 28);
+
+	// Channels of a quantised node that hold a single value for the whole
+	// clip. They have no timeline, the value is in the QuantisedNodeHeader.
+	using AnimChannelFlag = uint8_t;
+	constexpr AnimChannelFlag ANIM_CHANNEL_POSITION	= 0b0001;
+	constexpr AnimChannelFlag ANIM_CHANNEL_ROTATION	= 0b0010;
+	constexpr AnimChannelFlag ANIM_CHANNEL_SCALE			= 0b0100;
+
+	// value = offset + unorm16(xyz) * scale, for positions and scales
+	struct QuantisedVector
+	{
+		uint16_t x, y, z;
+	};
+
+	/***************************************************************************
+	 * Smallest three quaternion in 48 bits. The three smallest components of
+	 * the quaternion, flipped so the largest is positive, are 15 bit unorms
+	 * over [-1/sqrt(2), 1/sqrt(2)] at bits 0, 15 and 30. Bits 45-46 hold the
+	 * index of the dropped largest component, rebuilt as sqrt(1 - a²-b²-c²).
+	 * Bits are stored little endian across the three words.
+	 ***************************************************************************/
+	struct QuantisedRotation
+	{
+		uint16_t bits[3];
+	};
+
+	// One per node of a KEY_ENCODING_QUANTISED clip, after the node headers
+	struct QuantisedNodeHeader
+	{
+		// Dequantisation, or the value itself for a constant channel
+		SHVec3 positionOffset;
+		SHVec3 positionScale;
+		SHVec3 scaleOffset;
+		SHVec3 scaleScale;
+		// Only meaningful with ANIM_CHANNEL_ROTATION in constantChannels
+		SHVec4 rotation;
+
+		AnimChannelFlag constantChannels;
+		uint8_t padding[3];
+	};
+
+	static_assert(sizeof(QuantisedNodeHeader) == 68);
+
 	struct AnimDataHeader
 	{
 		uint32_t charCount;
 		uint32_t animNodeCount;
+		// Most keys in any one channel of the clip
 		uint32_t frameCount;
+		KeyEncodingFlag keyEncoding;
+		uint8_t padding[3];
+
+		uint32_t timelineCount;
+		uint32_t timeCount;
+		uint32_t positionCount;
+		uint32_t rotationCount;
+		uint32_t scaleCount;
+		uint32_t reserved[3];
 	};
 
+	static_assert(sizeof(AnimDataHeader) == 48);
+
 	// Main data containers
 	struct AnimNode
 	{
-		AnimationInterpolation interpolation;
+		// Nodes no channel targets keep the default
+		AnimationInterpolation interpolation{ AnimationInterpolation::DEFAULT };
 
 		std::vector<PositionKey> positionKeys;
 		std::vector<RotationKey> rotationKeys;
@@ -67,10 +166,22 @@ namespace SH_COMP
 	{
 		std::string name;
 
+		// Key times and duration are in ticks. Clips keep their source times
+		// in seconds at 1 tick per second unless they are resampled, then a
+		// tick is one sample.
 		double duration;
 		double ticksPerSecond;
 
 		//One node represents the animation transforms for one bone in the rig
 		std::vector<AnimNode> nodes;
+
+		// One per node when the clip is written with KEY_ENCODING_QUANTISED
+		std::vector<QuantisedNodeHeader> quantisedNodes;
+
+		// Shared key times and where each channel's keys are written, built
+		// by AnimationOptimiser::ShareTimelines
+		std::vector<KeyTimeline> timelines;
+		std::vector<float> times;
+		std::vector<AnimNodeHeader> nodeHeaders;
 	};
 }
\ No newline at end of file
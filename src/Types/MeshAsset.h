@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <string>
 
@@ -7,14 +8,156 @@
 
 namespace SH_COMP
 {
+	using VertexEncodingFlag = uint8_t;
+
+	// Compact stream encodings, decoded by the runtime in the vertex shader.
+	// Streams without a flag are written as full precision floats.
+	constexpr VertexEncodingFlag VERTEX_ENCODING_POSITION_UNORM16	= 0b0001;
+	constexpr VertexEncodingFlag VERTEX_ENCODING_NORMAL_OCT16			= 0b0010;
+	constexpr VertexEncodingFlag VERTEX_ENCODING_TEXCOORD_HALF		= 0b0100;
+
+	// position = positionOffset + unorm16(xyz) * positionScale, w is padding
+	struct QuantisedPosition
+	{
+		uint16_t x, y, z, w;
+	};
+
+	// Octahedral unit vector as snorm16, used for normals and tangents
+	struct OctahedralVector
+	{
+		int16_t x, y;
+	};
+
+	// IEEE 754 binary16 bits
+	struct HalfVec2
+	{
+		uint16_t x, y;
+	};
+
+	// Index range of one gltf primitive within the merged index buffer
+	struct SubMesh
+	{
+		uint32_t indexOffset;
+		uint32_t indexCount;
+		int32_t materialIndex;
+		// Range in the meshlet table, empty when meshlets were not built
+		uint32_t meshletOffset;
+		uint32_t meshletCount;
+	};
+
+	// Cluster of at most a few hundred triangles for mesh shader and GPU
+	// culling pipelines. Triangles are byte triples indexing into the
+	// meshlet's vertex list, which in turn indexes the mesh vertex streams.
+	struct Meshlet
+	{
+		uint32_t vertexOffset;
+		uint32_t triangleOffset;
+		uint32_t vertexCount;
+		uint32_t triangleCount;
+
+		float center[3];
+		float radius;
+
+		// Backfacing when dot(center - eye, coneAxis) >= coneCutoff * |center - eye| + radius
+		float coneAxis[3];
+		float coneCutoff;
+	};
+
+	struct IndexRange
+	{
+		uint32_t indexOffset;
+		uint32_t indexCount;
+	};
+
+	// Simplified level of detail drawing from the same vertex streams as the
+	// full mesh. Indices are a range of the mesh LOD index buffer, split per
+	// submesh by the LOD submesh table. error estimates, in model units, how
+	// far the simplified surface strays from the original.
+	struct MeshLod
+	{
+		uint32_t indexOffset;
+		uint32_t indexCount;
+		float error;
+	};
+
+	// Byte range within a .shmodel file, offset from the start of the file.
+	// Sections with nothing to write have size 0.
+	struct FileSection
+	{
+		uint64_t offset;
+		uint64_t size;
+	};
+
+	// Byte ranges within one mesh body
+	struct MeshSections
+	{
+		// Everything of the mesh, from its name to its last LOD index
+		FileSection body;
+		// Positions, tangents, normals and texture coordinates
+		FileSection vertices;
+		FileSection indices;
+		FileSection subMeshes;
+		// Weights followed by joints
+		FileSection skinning;
+		// Meshlet table, meshlet vertices and meshlet triangles
+		FileSection meshlets;
+		// LOD table and LOD submesh ranges
+		FileSection lods;
+		FileSection lodIndices;
+	};
+
+	static_assert(sizeof(MeshSections) == 128);
+
+	struct BoundingBox
+	{
+		SHVec3 min;
+		SHVec3 max;
+	};
+
+	struct BoundingSphere
+	{
+		SHVec3 center;
+		float radius;
+	};
+
 	struct MeshDataHeader
 	{
 		uint32_t vertexCount;
 		uint32_t indexCount;
 		uint32_t charCount;
-		bool hasWeights;
+		uint32_t subMeshCount;
+		uint32_t meshletCount;
+		uint32_t meshletVertexCount;
+		// In bytes, three per triangle
+		uint32_t meshletTriangleSize;
+		// Levels after the full mesh, each with subMeshCount index ranges
+		uint32_t lodCount;
+		uint32_t lodIndexCount;
+		// 0 or 1
+		uint8_t hasWeights;
+		VertexEncodingFlag vertexEncoding;
+		// Bytes per index, 2 or 4
+		uint8_t indexSize;
+		// Bytes per skinning component. Joints are unsigned integers of 1, 2
+		// or 4 bytes. Weights are unorm8, unorm16 or 4 byte floats.
+		uint8_t jointSize;
+		uint8_t weightSize;
+		uint8_t padding[3];
+
+		// Dequantisation of positions, unused without VERTEX_ENCODING_POSITION_UNORM16
+		SHVec3 positionOffset;
+		SHVec3 positionScale;
+
+		// Of the full precision positions, in mesh space
+		BoundingBox bounds;
+		BoundingSphere boundingSphere;
+
+		uint32_t reserved;
 	};
 
+	// Headers are written as is, so their layout is part of the file format
+	static_assert(sizeof(MeshDataHeader) == 112);
+
 	struct MeshData
 	{
 		std::string name;
@@ -24,6 +167,21 @@ namespace SH_COMP
 		std::vector<SHVec3> vertexNormal;
 		std::vector<SHVec2> texCoords;
 		std::vector<IndexType> indices;
+		std::vector<SubMesh> subMeshes;
+
+		std::vector<Meshlet> meshlets;
+		std::vector<uint32_t> meshletVertices;
+		std::vector<uint8_t> meshletTriangles;
+
+		std::vector<MeshLod> lods;
+		// Index range of submesh s in LOD l at [l * subMeshes.size() + s]
+		std::vector<IndexRange> lodSubMeshes;
+		std::vector<IndexType> lodIndices;
+
+		// Union of the gltf POSITION accessor min/max, valid only when every
+		// primitive declared them, saving a scan of the positions
+		BoundingBox sourceBounds;
+		bool hasSourceBounds{ false };
 
 		//Variable data
 		std::vector<SHVec4> weights;
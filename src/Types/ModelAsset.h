@@ -24,10 +24,37 @@ namespace SH_COMP
 
 	struct ModelAssetHeader
 	{
-		size_t meshCount;
-		size_t animCount;
+		// MODEL_FILE_MAGIC and the MODEL_COMPILER_VERSION that wrote the file
+		uint32_t magic;
+		uint32_t version;
+		uint32_t meshCount;
+		uint32_t animCount;
+
+		// Enclose every mesh, in mesh space as node transforms are not applied
+		BoundingBox bounds;
+		BoundingSphere boundingSphere;
+
+		uint32_t reserved[2];
 	};
 
+	static_assert(sizeof(ModelAssetHeader) == 64);
+
+	/***************************************************************************
+	 * Table of contents, written right after ModelAssetHeader and followed by
+	 * one MeshSections per mesh then one FileSection per animation clip, so a
+	 * loader can seek straight to any part of the file.
+	 ***************************************************************************/
+	struct ModelSections
+	{
+		FileSection meshHeaders;
+		FileSection animHeaders;
+		FileSection meshData;
+		FileSection animData;
+		FileSection rig;
+	};
+
+	static_assert(sizeof(ModelSections) == 80);
+
 	struct ModelAsset
 	{
 		ModelAssetHeader header;
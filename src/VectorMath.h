@@ -0,0 +1,115 @@
+/******************************************************************************
+ * \file    VectorMath.h
+ * \author  Loh Xiao Qi
+ * \brief   Vector and quaternion helpers over the PseudoMath types, shared
+ *					by the vertex and animation passes
+ *
+ * \copyright	Copyright (c) 2022 Digipen Institute of Technology. Reproduction
+ *						or disclosure of this file or its contents without the prior
+ *						written consent of Digipen Institute of Technology is prohibited
+ ******************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "PseudoMath.h"
+
+namespace SH_COMP
+{
+	constexpr float UNORM16_MAX{ 65535.f };
+
+	constexpr SHVec4 IDENTITY_ROTATION{ 0.f, 0.f, 0.f, 1.f };
+
+	// At or above this cosine slerp falls back to lerp, as the sine it divides
+	// by approaches 0. The lerp is not normalised.
+	constexpr float SLERP_MIN_COSINE{ 0.9995f };
+
+	// (value - offset) / scale rounded onto [0, 65535], 0 for an empty range
+	inline uint16_t ToUnorm16(float value, float offset, float scale) noexcept
+	{
+		if (scale <= 0.f)
+			return 0;
+
+		auto const normalised{ std::clamp((value - offset) / scale, 0.f, UNORM16_MAX) };
+		return static_cast<uint16_t>(std::lround(normalised));
+	}
+
+	inline float Distance(SHVec3 const& lhs, SHVec3 const& rhs) noexcept
+	{
+		float const x{ lhs.x - rhs.x };
+		float const y{ lhs.y - rhs.y };
+		float const z{ lhs.z - rhs.z };
+		return std::sqrt(x * x + y * y + z * z);
+	}
+
+	inline SHVec3 Lerp(SHVec3 const& from, SHVec3 const& to, float t) noexcept
+	{
+		return {
+			from.x + (to.x - from.x) * t,
+			from.y + (to.y - from.y) * t,
+			from.z + (to.z - from.z) * t
+		};
+	}
+
+	inline float Dot(SHVec4 const& lhs, SHVec4 const& rhs) noexcept
+	{
+		return lhs.x * rhs.x + lhs.y * rhs.y + lhs.z * rhs.z + lhs.w * rhs.w;
+	}
+
+	// Unit length, or the identity rotation for a zero quaternion
+	inline SHVec4 Normalise(SHVec4 const& value) noexcept
+	{
+		float const length{ std::sqrt(Dot(value, value)) };
+		if (length <= 0.f)
+			return IDENTITY_ROTATION;
+
+		return { value.x / length, value.y / length, value.z / length, value.w / length };
+	}
+
+	/***************************************************************************
+	 * Angle of the rotation between two quaternions, in radians. Taken from
+	 * the chord between them, as acos of their dot product cannot resolve
+	 * angles below ~1e-3 in float.
+	 ***************************************************************************/
+	inline float Angle(SHVec4 const& lhs, SHVec4 const& rhs) noexcept
+	{
+		auto const from{ Normalise(lhs) };
+		auto to{ Normalise(rhs) };
+		if (Dot(from, to) < 0.f)
+			to = { -to.x, -to.y, -to.z, -to.w };
+
+		SHVec4 const chord{ from.x - to.x, from.y - to.y, from.z - to.z, from.w - to.w };
+		return 4.f * std::asin(std::min(std::sqrt(Dot(chord, chord)) * 0.5f, 1.f));
+	}
+
+	// Shortest arc, as glTF specifies for LINEAR rotation samplers. Not
+	// normalised, the lerp fallback is slightly short of unit length.
+	inline SHVec4 Slerp(SHVec4 const& from, SHVec4 to, float t) noexcept
+	{
+		float cosine{ Dot(from, to) };
+		if (cosine < 0.f)
+		{
+			to = { -to.x, -to.y, -to.z, -to.w };
+			cosine = -cosine;
+		}
+
+		float fromWeight{ 1.f - t };
+		float toWeight{ t };
+		if (cosine < SLERP_MIN_COSINE)
+		{
+			float const theta{ std::acos(cosine) };
+			float const sine{ std::sin(theta) };
+			fromWeight = std::sin(fromWeight * theta) / sine;
+			toWeight = std::sin(toWeight * theta) / sine;
+		}
+
+		return {
+			from.x * fromWeight + to.x * toWeight,
+			from.y * fromWeight + to.y * toWeight,
+			from.z * fromWeight + to.z * toWeight,
+			from.w * fromWeight + to.w * toWeight
+		};
+	}
+}
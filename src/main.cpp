@@ -13,10 +13,255 @@
 
 #include <vector>
 #include <filesystem>
+#include <thread>
+#include <future>
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <algorithm>
+#include <cstdlib>
+
+/******************************************************************************
+ * Compiles every path on a pool of jobCount worker threads. Each job logs into
+ * its own buffer and the buffers are flushed in input order, so the console
+ * output is identical regardless of scheduling.
+ *
+ * \return Number of files that failed to compile
+ ******************************************************************************/
+static size_t CompileAll(std::vector<std::string> const& paths, SH_COMP::CompileOptions const& options, unsigned jobCount)
+{
+	std::vector<std::promise<std::string>> logs(paths.size());
+	std::vector<std::future<std::string>> results;
+	results.reserve(paths.size());
+	for (auto& log : logs)
+	{
+		results.emplace_back(log.get_future());
+	}
+
+	std::atomic<size_t> next{ 0 };
+	std::atomic<size_t> failed{ 0 };
+
+	auto const worker = [&]()
+	{
+		for (auto i{ next++ }; i < paths.size(); i = next++)
+		{
+			std::ostringstream log;
+			if (!SH_COMP::MeshCompiler::LoadAndCompile(paths[i], options, log))
+				++failed;
+			logs[i].set_value(log.str());
+		}
+	};
+
+	jobCount = std::max(1u, std::min(jobCount, static_cast<unsigned>(paths.size())));
+	std::vector<std::jthread> workers;
+	workers.reserve(jobCount);
+	for (auto i{ 0u }; i < jobCount; ++i)
+	{
+		workers.emplace_back(worker);
+	}
+
+	for (auto& result : results)
+	{
+		std::cout << result.get() << std::flush;
+	}
+
+	return failed;
+}
+
+/******************************************************************************
+ * Reads up to three comma separated floats into position, rotation and scale
+ * in that order. Missing values keep what tolerance already holds.
+ ******************************************************************************/
+static void ParseKeyTolerance(std::string const& values, SH_COMP::KeyframeTolerance& tolerance)
+{
+	float* const fields[]{ &tolerance.position, &tolerance.rotation, &tolerance.scale };
+	char const* cursor{ values.c_str() };
+	for (auto* field : fields)
+	{
+		char* end{ nullptr };
+		auto const value{ std::strtof(cursor, &end) };
+		if (end == cursor)
+			break;
+
+		*field = value;
+		if (*end != ',')
+			break;
+		cursor = end + 1;
+	}
+}
 
 int main(int argc, char* argv[])
 {	
 	std::vector<std::string> paths;
+	unsigned jobCount{ std::thread::hardware_concurrency() };
+	SH_COMP::CompileOptions options;
+
+	// Strip options out of argv, leaving only file paths
+	std::vector<char*> args{ argv[0] };
+	for (int i { 1 }; i < argc; ++i)
+	{
+		std::string_view const arg{ argv[i] };
+		if (arg.starts_with("-j"))
+		{
+			auto const value{ arg.size() > 2 ? arg.substr(2) : (i + 1 < argc ? std::string_view{ argv[++i] } : "") };
+			jobCount = static_cast<unsigned>(std::strtoul(std::string{ value }.c_str(), nullptr, 10));
+			if (jobCount == 0)
+			{
+				std::cout << "Invalid job count: " << value << std::endl;
+				return 1;
+			}
+		}
+		else if (arg == "-f" || arg == "--force")
+		{
+			options.useCache = false;
+		}
+		else if (arg == "--no-mmap")
+		{
+			options.mapSourceBuffers = false;
+		}
+		else if (arg == "--weld")
+		{
+			options.weldVertices = true;
+		}
+		else if (arg.starts_with("--weld-epsilon="))
+		{
+			options.weldVertices = true;
+			options.weldEpsilon = std::strtof(std::string{ arg.substr(arg.find('=') + 1) }.c_str(), nullptr);
+		}
+		else if (arg == "--quantise")
+		{
+			options.quantisePositions = true;
+			options.quantiseNormals = true;
+			options.quantiseTexCoords = true;
+		}
+		else if (arg == "--quantise-positions")
+		{
+			options.quantisePositions = true;
+		}
+		else if (arg == "--quantise-normals")
+		{
+			options.quantiseNormals = true;
+		}
+		else if (arg == "--quantise-uvs")
+		{
+			options.quantiseTexCoords = true;
+		}
+		else if (arg == "--compact-skin" || arg == "--compact-skin=8")
+		{
+			options.compactSkinning = true;
+			options.skinWeightBits = 8;
+		}
+		else if (arg == "--compact-skin=16")
+		{
+			options.compactSkinning = true;
+			options.skinWeightBits = 16;
+		}
+		else if (arg == "--meshlets")
+		{
+			options.buildMeshlets = true;
+		}
+		else if (arg.starts_with("--meshlets="))
+		{
+			// --meshlets=<max vertices>,<max triangles>
+			options.buildMeshlets = true;
+			char* end{ nullptr };
+			std::string const limits{ arg.substr(arg.find('=') + 1) };
+			options.meshletMaxVertices = std::strtoul(limits.c_str(), &end, 10);
+			if (*end == ',')
+				options.meshletMaxTriangles = std::strtoul(end + 1, nullptr, 10);
+		}
+		else if (arg == "--lod")
+		{
+			options.lodRatios = { 0.5f, 0.25f, 0.125f };
+		}
+		else if (arg.starts_with("--lod="))
+		{
+			// --lod=<ratio>,<ratio>,...
+			options.lodRatios.clear();
+			std::string const ratios{ arg.substr(arg.find('=') + 1) };
+			char const* cursor{ ratios.c_str() };
+			while (*cursor != '\0')
+			{
+				char* end{ nullptr };
+				auto const ratio{ std::strtof(cursor, &end) };
+				if (end == cursor)
+					break;
+
+				options.lodRatios.push_back(ratio);
+				cursor = *end == ',' ? end + 1 : end;
+			}
+		}
+		else if (arg.starts_with("--lod-error="))
+		{
+			options.lodMaxError = std::strtof(std::string{ arg.substr(arg.find('=') + 1) }.c_str(), nullptr);
+		}
+		else if (arg == "--reduce-keys")
+		{
+			options.reduceKeyframes = true;
+		}
+		else if (arg.starts_with("--reduce-keys="))
+		{
+			// --reduce-keys=<position>,<rotation radians>,<scale>
+			options.reduceKeyframes = true;
+			ParseKeyTolerance(std::string{ arg.substr(arg.find('=') + 1) }, options.keyTolerance);
+		}
+		else if (arg.starts_with("--reduce-keys:") && arg.find('=') != std::string_view::npos)
+		{
+			// --reduce-keys:<clip>=<position>,<rotation radians>,<scale>, unset
+			// values are taken from the tolerance given before it
+			options.reduceKeyframes = true;
+			auto const split{ arg.find('=') };
+			std::string const clip{ arg.substr(14, split - 14) };
+			auto& tolerance{ options.clipKeyTolerances.try_emplace(clip, options.keyTolerance).first->second };
+			ParseKeyTolerance(std::string{ arg.substr(split + 1) }, tolerance);
+		}
+		else if (arg == "--quantise-keys")
+		{
+			options.quantiseKeys = true;
+		}
+		else if (arg.starts_with("--quantise-keys="))
+		{
+			// --quantise-keys=<position>,<rotation radians>,<scale> error budget
+			options.quantiseKeys = true;
+			ParseKeyTolerance(std::string{ arg.substr(arg.find('=') + 1) }, options.keyQuantisationBudget);
+		}
+		else if (arg.starts_with("--quantise-keys:"))
+		{
+			// --quantise-keys:<clip>, repeat to quantise several clips
+			options.quantiseKeys = true;
+			options.quantisedClips.emplace(arg.substr(16));
+		}
+		else if (arg.starts_with("--resample="))
+		{
+			// --resample=<samples per second> for every clip
+			options.sampleRate = std::strtof(std::string{ arg.substr(arg.find('=') + 1) }.c_str(), nullptr);
+		}
+		else if (arg.starts_with("--resample:") && arg.find('=') != std::string_view::npos)
+		{
+			// --resample:<clip>=<samples per second>, 0 keeps the clip's keys
+			auto const split{ arg.find('=') };
+			std::string const clip{ arg.substr(11, split - 11) };
+			options.clipSampleRates[clip] = std::strtof(std::string{ arg.substr(split + 1) }.c_str(), nullptr);
+		}
+		else if (arg == "--verify")
+		{
+			options.verifyOutput = true;
+		}
+		else if (arg == "--vcache")
+		{
+			options.optimiseVertexCache = true;
+		}
+		else if (arg == "--vfetch")
+		{
+			options.optimiseVertexFetch = true;
+		}
+		else
+		{
+			args.push_back(argv[i]);
+		}
+	}
+	argc = static_cast<int>(args.size());
+	argv = args.data();
 	
 	#if 1
 
@@ -29,6 +274,7 @@ int main(int argc, char* argv[])
 				std::filesystem::recursive_directory_iterator{ ASSET_ROOT })
 			{
 				if (dir.path().extension().string() == GLTF_EXTENSION || 
+					dir.path().extension().string() == GLB_EXTENSION || 
 					dir.path().extension().string() == FBX_EXTENSION)
 				{
 					auto path = dir.path();
@@ -46,6 +292,7 @@ int main(int argc, char* argv[])
 		for (auto& dir : std::filesystem::directory_iterator{ "./" })
 		{
 				if (dir.path().extension().string() == GLTF_EXTENSION || 
+					dir.path().extension().string() == GLB_EXTENSION || 
 					dir.path().extension().string() == FBX_EXTENSION)
 				{
 					auto path = dir.path();
@@ -63,10 +310,13 @@ int main(int argc, char* argv[])
 		}
 	}
 
-	for (auto const& path : paths)
+	// Jobs split the hardware threads between them for their own passes
+	auto const busyJobs{ std::max(1u, std::min(jobCount, static_cast<unsigned>(paths.size()))) };
+	options.threadsPerJob = std::max(1u, std::thread::hardware_concurrency() / busyJobs);
+
+	if (CompileAll(paths, options, jobCount) > 0)
 	{
-		SH_COMP::MeshCompiler::LoadAndCompile(path);
-		std::cout << "[Mesh Compiler] Compiled file: " << path << std::endl;
+		return 1;
 	}
 	
 	#else